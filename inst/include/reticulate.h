@@ -0,0 +1,33 @@
+#ifndef RETICULATE_H
+#define RETICULATE_H
+
+// C API for packages which convert their own Python types to R. Include
+// Python.h (and Rinternals.h) before this header, and add reticulate to
+// the package's LinkingTo field.
+//
+// A converter registered for a Python type is called by reticulate's
+// py_to_r() for every object of (exactly) that type, with a borrowed
+// reference to the object. It returns the R object the Python object is
+// converted to, or NULL to decline to convert the object (set a Python
+// error too, to signal an error). Converters must not raise R errors.
+//
+// Register converters from the main thread, while holding the GIL (e.g.
+// from code called through reticulate, once Python is initialized);
+// registering a NULL converter removes a type's converter. Returns 0 on
+// success, or -1 if 'type' is not a Python type.
+
+#include <R_ext/Rdynload.h>
+
+typedef SEXP (*reticulate_py_to_r_converter)(PyObject* x, int convert);
+
+static inline int reticulate_register_py_to_r(PyObject* type,
+                                              reticulate_py_to_r_converter converter)
+{
+  typedef int (*register_fn)(PyObject*, reticulate_py_to_r_converter);
+  static register_fn fn = NULL;
+  if (fn == NULL)
+    fn = (register_fn) R_GetCCallable("reticulate", "register_py_to_r");
+  return fn(type, converter);
+}
+
+#endif // RETICULATE_H
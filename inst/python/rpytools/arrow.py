@@ -0,0 +1,14 @@
+
+def record_batch_reader(exported):
+  """Import an ArrowArrayStream exported from R as a pyarrow.RecordBatchReader.
+
+  `exported` is a tuple holding a PyCapsule which owns the stream, along
+  with the address of that stream (for versions of pyarrow which predate
+  the Arrow PyCapsule interface).
+  """
+  import pyarrow
+  capsule, address = exported
+  reader = pyarrow.RecordBatchReader
+  if hasattr(reader, "_import_from_c_capsule"):
+    return reader._import_from_c_capsule(capsule)
+  return reader._import_from_c(address)
@@ -0,0 +1,112 @@
+
+# Pickles whose large buffers (e.g. the data of NumPy arrays) are stored
+# out-of-band, with pickle protocol 5. The buffers are written to the file
+# after the pickle, each aligned to a page boundary, and are loaded by
+# memory-mapping the file, so that they are only read from disk as they're
+# used (and are not copied into the pickle stream, nor out of it).
+#
+# Files are laid out as:
+#
+#   magic          8 bytes, "RPKLBUF\0"
+#   version        uint64 (little-endian, as are all integers)
+#   pickle offset  uint64
+#   pickle size    uint64
+#   buffer count   uint64
+#   buffers        (offset uint64, size uint64), for each buffer
+#   the pickle, and then the buffers
+
+import struct
+
+MAGIC = b"RPKLBUF\0"
+VERSION = 1
+ALIGNMENT = 4096
+
+_HEADER = struct.Struct("<8sQQQQ")
+_ENTRY = struct.Struct("<QQ")
+
+
+def _import_pickle(pickle):
+  import importlib
+  return importlib.import_module(pickle)
+
+
+def _aligned(position):
+  return position + (-position % ALIGNMENT)
+
+
+def is_buffered_pickle(filename):
+  """Was the file written by dump()?"""
+  with open(filename, "rb") as handle:
+    return handle.read(len(MAGIC)) == MAGIC
+
+
+def dump(obj, filename, pickle="pickle", threshold=65536, **kwargs):
+  """Pickle an object to a file, storing buffers of at least `threshold`
+  bytes out-of-band."""
+  protocol = kwargs.pop("protocol", 5)
+  if protocol != 5:
+    raise ValueError("out-of-band buffers require pickle protocol 5, not %r" % (protocol,))
+
+  pickle = _import_pickle(pickle)
+  if getattr(pickle, "HIGHEST_PROTOCOL", 5) < 5:
+    raise ValueError("out-of-band buffers require pickle protocol 5 (Python 3.8 or later)")
+
+  buffers = []
+  def buffer_callback(buffer):
+    try:
+      raw = buffer.raw()
+    except BufferError:
+      return True  # not contiguous, so it's serialized in-band
+    if raw.nbytes < threshold:
+      return True
+    buffers.append(raw)
+    return False
+
+  data = pickle.dumps(obj, protocol=5, buffer_callback=buffer_callback, **kwargs)
+
+  # lay out the pickle after the header, and the buffers after the pickle
+  offset = _HEADER.size + _ENTRY.size * len(buffers)
+  position = offset + len(data)
+  entries = []
+  for raw in buffers:
+    position = _aligned(position)
+    entries.append((position, raw.nbytes))
+    position += raw.nbytes
+
+  with open(filename, "wb") as handle:
+    handle.write(_HEADER.pack(MAGIC, VERSION, offset, len(data), len(buffers)))
+    for entry in entries:
+      handle.write(_ENTRY.pack(*entry))
+    handle.write(data)
+    for raw, (start, size) in zip(buffers, entries):
+      handle.write(b"\0" * (start - handle.tell()))
+      handle.write(raw)
+
+
+def load(filename, pickle="pickle", **kwargs):
+  """Load an object pickled by dump(), memory-mapping its buffers."""
+  import mmap
+  pickle = _import_pickle(pickle)
+
+  with open(filename, "rb") as handle:
+
+    magic, version, offset, size, count = _HEADER.unpack(handle.read(_HEADER.size))
+    if magic != MAGIC:
+      raise ValueError("'%s' was not written with out-of-band buffers" % filename)
+    if version != VERSION:
+      raise ValueError("'%s' has unsupported version %d" % (filename, version))
+
+    entries = [_ENTRY.unpack(handle.read(_ENTRY.size)) for i in range(count)]
+    handle.seek(offset)
+    data = handle.read(size)
+
+    # the mapping is copy-on-write, so that the objects loaded are writable
+    # (without writing to the file); it remains open (and the file mapped)
+    # for as long as any of the buffers are in use
+    buffers = []
+    if count:
+      mapped = mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_COPY)
+      view = memoryview(mapped)
+      buffers = [view[start:start + length] for start, length in entries]
+
+  return pickle.loads(data, buffers=buffers, **kwargs)
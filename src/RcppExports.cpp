@@ -43,6 +43,15 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_clear_class_cache
+void py_clear_class_cache();
+RcppExport SEXP _reticulate_py_clear_class_cache() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    py_clear_class_cache();
+    return R_NilValue;
+END_RCPP
+}
 // py_is_null_xptr
 bool py_is_null_xptr(PyObjectRef x);
 RcppExport SEXP _reticulate_py_is_null_xptr(SEXP xSEXP) {
@@ -64,6 +73,28 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// py_get_convert
+bool py_get_convert(PyObjectRef x);
+RcppExport SEXP _reticulate_py_get_convert(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_get_convert(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_set_convert
+void py_set_convert(PyObjectRef x, bool convert);
+RcppExport SEXP _reticulate_py_set_convert(SEXP xSEXP, SEXP convertSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type x(xSEXP);
+    Rcpp::traits::input_parameter< bool >::type convert(convertSEXP);
+    py_set_convert(x, convert);
+    return R_NilValue;
+END_RCPP
+}
 // py_flush_output
 SEXP py_flush_output();
 RcppExport SEXP _reticulate_py_flush_output() {
@@ -129,6 +160,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_fast_r_function
+PyObjectRef py_fast_r_function(RObject f, bool convert);
+RcppExport SEXP _reticulate_py_fast_r_function(SEXP fSEXP, SEXP convertSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< RObject >::type f(fSEXP);
+    Rcpp::traits::input_parameter< bool >::type convert(convertSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_fast_r_function(f, convert));
+    return rcpp_result_gen;
+END_RCPP
+}
 // py_activate_virtualenv
 void py_activate_virtualenv(const std::string& script);
 RcppExport SEXP _reticulate_py_activate_virtualenv(SEXP scriptSEXP) {
@@ -139,6 +182,26 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// py_profile_start_impl
+void py_profile_start_impl(int interval);
+RcppExport SEXP _reticulate_py_profile_start_impl(SEXP intervalSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type interval(intervalSEXP);
+    py_profile_start_impl(interval);
+    return R_NilValue;
+END_RCPP
+}
+// py_profile_stop_impl
+IntegerVector py_profile_stop_impl();
+RcppExport SEXP _reticulate_py_profile_stop_impl() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(py_profile_stop_impl());
+    return rcpp_result_gen;
+END_RCPP
+}
 // main_process_python_info
 SEXP main_process_python_info();
 RcppExport SEXP _reticulate_main_process_python_info() {
@@ -169,8 +232,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // py_initialize
-void py_initialize(const std::string& python, const std::string& libpython, const std::string& pythonhome, const std::string& virtualenv_activate, bool python3, bool interactive, const std::string& numpy_load_error);
-RcppExport SEXP _reticulate_py_initialize(SEXP pythonSEXP, SEXP libpythonSEXP, SEXP pythonhomeSEXP, SEXP virtualenv_activateSEXP, SEXP python3SEXP, SEXP interactiveSEXP, SEXP numpy_load_errorSEXP) {
+void py_initialize(const std::string& python, const std::string& libpython, const std::string& pythonhome, const std::string& virtualenv_activate, bool python3, bool interactive, const std::string& numpy_load_error, bool defer_numpy);
+RcppExport SEXP _reticulate_py_initialize(SEXP pythonSEXP, SEXP libpythonSEXP, SEXP pythonhomeSEXP, SEXP virtualenv_activateSEXP, SEXP python3SEXP, SEXP interactiveSEXP, SEXP numpy_load_errorSEXP, SEXP defer_numpySEXP) {
 BEGIN_RCPP
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type python(pythonSEXP);
@@ -180,7 +243,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< bool >::type python3(python3SEXP);
     Rcpp::traits::input_parameter< bool >::type interactive(interactiveSEXP);
     Rcpp::traits::input_parameter< const std::string& >::type numpy_load_error(numpy_load_errorSEXP);
-    py_initialize(python, libpython, pythonhome, virtualenv_activate, python3, interactive, numpy_load_error);
+    Rcpp::traits::input_parameter< bool >::type defer_numpy(defer_numpySEXP);
+    py_initialize(python, libpython, pythonhome, virtualenv_activate, python3, interactive, numpy_load_error, defer_numpy);
     return R_NilValue;
 END_RCPP
 }
@@ -193,6 +257,36 @@ BEGIN_RCPP
     return R_NilValue;
 END_RCPP
 }
+// py_event_loop_stats_impl
+SEXP py_event_loop_stats_impl();
+RcppExport SEXP _reticulate_py_event_loop_stats_impl() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(py_event_loop_stats_impl());
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_conversion_stats_impl
+SEXP py_conversion_stats_impl();
+RcppExport SEXP _reticulate_py_conversion_stats_impl() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(py_conversion_stats_impl());
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_conversion_stats_reset_impl
+void py_conversion_stats_reset_impl(bool enable);
+RcppExport SEXP _reticulate_py_conversion_stats_reset_impl(SEXP enableSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type enable(enableSEXP);
+    py_conversion_stats_reset_impl(enable);
+    return R_NilValue;
+END_RCPP
+}
 // py_is_none
 bool py_is_none(PyObjectRef x);
 RcppExport SEXP _reticulate_py_is_none(SEXP xSEXP) {
@@ -403,6 +497,55 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_call_map_impl
+SEXP py_call_map_impl(PyObjectRef f, List args, List keywords);
+RcppExport SEXP _reticulate_py_call_map_impl(SEXP fSEXP, SEXP argsSEXP, SEXP keywordsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type f(fSEXP);
+    Rcpp::traits::input_parameter< List >::type args(argsSEXP);
+    Rcpp::traits::input_parameter< List >::type keywords(keywordsSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_call_map_impl(f, args, keywords));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_call_async_impl
+SEXP py_call_async_impl(PyObjectRef f, List args, List keywords);
+RcppExport SEXP _reticulate_py_call_async_impl(SEXP fSEXP, SEXP argsSEXP, SEXP keywordsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type f(fSEXP);
+    Rcpp::traits::input_parameter< List >::type args(argsSEXP);
+    Rcpp::traits::input_parameter< List >::type keywords(keywordsSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_call_async_impl(f, args, keywords));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_call_async_done
+bool py_call_async_done(SEXP ptr, double timeout);
+RcppExport SEXP _reticulate_py_call_async_done(SEXP ptrSEXP, SEXP timeoutSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type ptr(ptrSEXP);
+    Rcpp::traits::input_parameter< double >::type timeout(timeoutSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_call_async_done(ptr, timeout));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_call_async_value
+SEXP py_call_async_value(SEXP ptr);
+RcppExport SEXP _reticulate_py_call_async_value(SEXP ptrSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type ptr(ptrSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_call_async_value(ptr));
+    return rcpp_result_gen;
+END_RCPP
+}
 // py_dict_impl
 PyObjectRef py_dict_impl(const List& keys, const List& items, bool convert);
 RcppExport SEXP _reticulate_py_dict_impl(SEXP keysSEXP, SEXP itemsSEXP, SEXP convertSEXP) {
@@ -473,6 +616,17 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_records_to_df_impl
+SEXP py_records_to_df_impl(PyObjectRef records);
+RcppExport SEXP _reticulate_py_records_to_df_impl(SEXP recordsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type records(recordsSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_records_to_df_impl(records));
+    return rcpp_result_gen;
+END_RCPP
+}
 // py_tuple
 PyObjectRef py_tuple(const List& items, bool convert);
 RcppExport SEXP _reticulate_py_tuple(SEXP itemsSEXP, SEXP convertSEXP) {
@@ -553,6 +707,38 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_iter_next_batch
+SEXP py_iter_next_batch(PyObjectRef iterator, int n, RObject completed);
+RcppExport SEXP _reticulate_py_iter_next_batch(SEXP iteratorSEXP, SEXP nSEXP, SEXP completedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type iterator(iteratorSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< RObject >::type completed(completedSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_iter_next_batch(iterator, n, completed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_code_cache_clear_impl
+void py_code_cache_clear_impl();
+RcppExport SEXP _reticulate_py_code_cache_clear_impl() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    py_code_cache_clear_impl();
+    return R_NilValue;
+END_RCPP
+}
+// py_code_cache_stats_impl
+SEXP py_code_cache_stats_impl();
+RcppExport SEXP _reticulate_py_code_cache_stats_impl() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(py_code_cache_stats_impl());
+    return rcpp_result_gen;
+END_RCPP
+}
 // py_run_string_impl
 SEXP py_run_string_impl(const std::string& code, bool local, bool convert);
 RcppExport SEXP _reticulate_py_run_string_impl(SEXP codeSEXP, SEXP localSEXP, SEXP convertSEXP) {
@@ -613,6 +799,49 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// py_arrow_c_stream_allocate
+SEXP py_arrow_c_stream_allocate();
+RcppExport SEXP _reticulate_py_arrow_c_stream_allocate() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(py_arrow_c_stream_allocate());
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_arrow_c_stream_address
+double py_arrow_c_stream_address(SEXP ptr);
+RcppExport SEXP _reticulate_py_arrow_c_stream_address(SEXP ptrSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type ptr(ptrSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_arrow_c_stream_address(ptr));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_arrow_c_stream_import
+SEXP py_arrow_c_stream_import(PyObjectRef x);
+RcppExport SEXP _reticulate_py_arrow_c_stream_import(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_arrow_c_stream_import(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_arrow_c_stream_export
+PyObjectRef py_arrow_c_stream_export(SEXP ptr);
+RcppExport SEXP _reticulate_py_arrow_c_stream_export(SEXP ptrSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type ptr(ptrSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_arrow_c_stream_export(ptr));
+    return rcpp_result_gen;
+END_RCPP
+}
 // r_convert_dataframe
 PyObjectRef r_convert_dataframe(RObject dataframe, bool convert);
 RcppExport SEXP _reticulate_r_convert_dataframe(SEXP dataframeSEXP, SEXP convertSEXP) {
@@ -625,6 +854,30 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// r_to_py_sparse_impl
+PyObjectRef r_to_py_sparse_impl(RObject x, bool convert);
+RcppExport SEXP _reticulate_r_to_py_sparse_impl(SEXP xSEXP, SEXP convertSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< RObject >::type x(xSEXP);
+    Rcpp::traits::input_parameter< bool >::type convert(convertSEXP);
+    rcpp_result_gen = Rcpp::wrap(r_to_py_sparse_impl(x, convert));
+    return rcpp_result_gen;
+END_RCPP
+}
+// py_to_r_sparse_impl
+SEXP py_to_r_sparse_impl(PyObjectRef x, const std::string& format);
+RcppExport SEXP _reticulate_py_to_r_sparse_impl(SEXP xSEXP, SEXP formatSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< PyObjectRef >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type format(formatSEXP);
+    rcpp_result_gen = Rcpp::wrap(py_to_r_sparse_impl(x, format));
+    return rcpp_result_gen;
+END_RCPP
+}
 // r_convert_date
 PyObjectRef r_convert_date(DateVector dates, bool convert);
 RcppExport SEXP _reticulate_r_convert_date(SEXP datesSEXP, SEXP convertSEXP) {
@@ -763,20 +1016,29 @@ static const R_CallMethodDef CallEntries[] = {
     {"_reticulate_write_stdout", (DL_FUNC) &_reticulate_write_stdout, 1},
     {"_reticulate_write_stderr", (DL_FUNC) &_reticulate_write_stderr, 1},
     {"_reticulate_is_python3", (DL_FUNC) &_reticulate_is_python3, 0},
+    {"_reticulate_py_clear_class_cache", (DL_FUNC) &_reticulate_py_clear_class_cache, 0},
     {"_reticulate_py_is_null_xptr", (DL_FUNC) &_reticulate_py_is_null_xptr, 1},
     {"_reticulate_py_validate_xptr", (DL_FUNC) &_reticulate_py_validate_xptr, 1},
+    {"_reticulate_py_get_convert", (DL_FUNC) &_reticulate_py_get_convert, 1},
+    {"_reticulate_py_set_convert", (DL_FUNC) &_reticulate_py_set_convert, 2},
     {"_reticulate_py_flush_output", (DL_FUNC) &_reticulate_py_flush_output, 0},
     {"_reticulate_conditionMessage_from_py_exception", (DL_FUNC) &_reticulate_conditionMessage_from_py_exception, 1},
     {"_reticulate_py_none_impl", (DL_FUNC) &_reticulate_py_none_impl, 0},
     {"_reticulate_py_is_callable", (DL_FUNC) &_reticulate_py_is_callable, 1},
     {"_reticulate_py_get_formals", (DL_FUNC) &_reticulate_py_get_formals, 1},
     {"_reticulate_r_to_py_impl", (DL_FUNC) &_reticulate_r_to_py_impl, 2},
+    {"_reticulate_py_fast_r_function", (DL_FUNC) &_reticulate_py_fast_r_function, 2},
     {"_reticulate_py_activate_virtualenv", (DL_FUNC) &_reticulate_py_activate_virtualenv, 1},
+    {"_reticulate_py_profile_start_impl", (DL_FUNC) &_reticulate_py_profile_start_impl, 1},
+    {"_reticulate_py_profile_stop_impl", (DL_FUNC) &_reticulate_py_profile_stop_impl, 0},
     {"_reticulate_main_process_python_info", (DL_FUNC) &_reticulate_main_process_python_info, 0},
     {"_reticulate_py_clear_error", (DL_FUNC) &_reticulate_py_clear_error, 0},
     {"_reticulate_was_python_initialized_by_reticulate", (DL_FUNC) &_reticulate_was_python_initialized_by_reticulate, 0},
-    {"_reticulate_py_initialize", (DL_FUNC) &_reticulate_py_initialize, 7},
+    {"_reticulate_py_initialize", (DL_FUNC) &_reticulate_py_initialize, 8},
     {"_reticulate_py_finalize", (DL_FUNC) &_reticulate_py_finalize, 0},
+    {"_reticulate_py_event_loop_stats_impl", (DL_FUNC) &_reticulate_py_event_loop_stats_impl, 0},
+    {"_reticulate_py_conversion_stats_impl", (DL_FUNC) &_reticulate_py_conversion_stats_impl, 0},
+    {"_reticulate_py_conversion_stats_reset_impl", (DL_FUNC) &_reticulate_py_conversion_stats_reset_impl, 1},
     {"_reticulate_py_is_none", (DL_FUNC) &_reticulate_py_is_none, 1},
     {"_reticulate_py_compare_impl", (DL_FUNC) &_reticulate_py_compare_impl, 3},
     {"_reticulate_py_str_impl", (DL_FUNC) &_reticulate_py_str_impl, 1},
@@ -795,12 +1057,17 @@ static const R_CallMethodDef CallEntries[] = {
     {"_reticulate_py_ref_to_r_with_convert", (DL_FUNC) &_reticulate_py_ref_to_r_with_convert, 2},
     {"_reticulate_py_ref_to_r", (DL_FUNC) &_reticulate_py_ref_to_r, 1},
     {"_reticulate_py_call_impl", (DL_FUNC) &_reticulate_py_call_impl, 3},
+    {"_reticulate_py_call_map_impl", (DL_FUNC) &_reticulate_py_call_map_impl, 3},
+    {"_reticulate_py_call_async_impl", (DL_FUNC) &_reticulate_py_call_async_impl, 3},
+    {"_reticulate_py_call_async_done", (DL_FUNC) &_reticulate_py_call_async_done, 2},
+    {"_reticulate_py_call_async_value", (DL_FUNC) &_reticulate_py_call_async_value, 1},
     {"_reticulate_py_dict_impl", (DL_FUNC) &_reticulate_py_dict_impl, 3},
     {"_reticulate_py_dict_get_item", (DL_FUNC) &_reticulate_py_dict_get_item, 2},
     {"_reticulate_py_dict_set_item", (DL_FUNC) &_reticulate_py_dict_set_item, 3},
     {"_reticulate_py_dict_length", (DL_FUNC) &_reticulate_py_dict_length, 1},
     {"_reticulate_py_dict_get_keys", (DL_FUNC) &_reticulate_py_dict_get_keys, 1},
     {"_reticulate_py_dict_get_keys_as_str", (DL_FUNC) &_reticulate_py_dict_get_keys_as_str, 1},
+    {"_reticulate_py_records_to_df_impl", (DL_FUNC) &_reticulate_py_records_to_df_impl, 1},
     {"_reticulate_py_tuple", (DL_FUNC) &_reticulate_py_tuple, 2},
     {"_reticulate_py_tuple_length", (DL_FUNC) &_reticulate_py_tuple_length, 1},
     {"_reticulate_py_module_import", (DL_FUNC) &_reticulate_py_module_import, 2},
@@ -808,12 +1075,21 @@ static const R_CallMethodDef CallEntries[] = {
     {"_reticulate_py_list_submodules", (DL_FUNC) &_reticulate_py_list_submodules, 1},
     {"_reticulate_py_iterate", (DL_FUNC) &_reticulate_py_iterate, 2},
     {"_reticulate_py_iter_next", (DL_FUNC) &_reticulate_py_iter_next, 2},
+    {"_reticulate_py_iter_next_batch", (DL_FUNC) &_reticulate_py_iter_next_batch, 3},
+    {"_reticulate_py_code_cache_clear_impl", (DL_FUNC) &_reticulate_py_code_cache_clear_impl, 0},
+    {"_reticulate_py_code_cache_stats_impl", (DL_FUNC) &_reticulate_py_code_cache_stats_impl, 0},
     {"_reticulate_py_run_string_impl", (DL_FUNC) &_reticulate_py_run_string_impl, 3},
     {"_reticulate_py_run_file_impl", (DL_FUNC) &_reticulate_py_run_file_impl, 3},
     {"_reticulate_py_eval_impl", (DL_FUNC) &_reticulate_py_eval_impl, 2},
     {"_reticulate_py_convert_pandas_series", (DL_FUNC) &_reticulate_py_convert_pandas_series, 1},
     {"_reticulate_py_convert_pandas_df", (DL_FUNC) &_reticulate_py_convert_pandas_df, 1},
+    {"_reticulate_py_arrow_c_stream_allocate", (DL_FUNC) &_reticulate_py_arrow_c_stream_allocate, 0},
+    {"_reticulate_py_arrow_c_stream_address", (DL_FUNC) &_reticulate_py_arrow_c_stream_address, 1},
+    {"_reticulate_py_arrow_c_stream_import", (DL_FUNC) &_reticulate_py_arrow_c_stream_import, 1},
+    {"_reticulate_py_arrow_c_stream_export", (DL_FUNC) &_reticulate_py_arrow_c_stream_export, 1},
     {"_reticulate_r_convert_dataframe", (DL_FUNC) &_reticulate_r_convert_dataframe, 2},
+    {"_reticulate_r_to_py_sparse_impl", (DL_FUNC) &_reticulate_r_to_py_sparse_impl, 2},
+    {"_reticulate_py_to_r_sparse_impl", (DL_FUNC) &_reticulate_py_to_r_sparse_impl, 2},
     {"_reticulate_r_convert_date", (DL_FUNC) &_reticulate_r_convert_date, 2},
     {"_reticulate_py_set_interrupt_impl", (DL_FUNC) &_reticulate_py_set_interrupt_impl, 0},
     {"_reticulate_py_list_length", (DL_FUNC) &_reticulate_py_list_length, 1},
@@ -829,7 +1105,11 @@ static const R_CallMethodDef CallEntries[] = {
     {NULL, NULL, 0}
 };
 
+void reticulate_init_altrep(DllInfo* dll);
+void reticulate_init_ccallables(DllInfo* dll);
 RcppExport void R_init_reticulate(DllInfo *dll) {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    reticulate_init_altrep(dll);
+    reticulate_init_ccallables(dll);
 }
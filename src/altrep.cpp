@@ -0,0 +1,588 @@
+//
+// ALTREP classes used to expose Python-owned memory to R without copying.
+//
+// A NumPy array whose dtype and memory layout already match R's own
+// representation (e.g. a Fortran-contiguous, aligned, native-endian float64
+// array) can be handed to R as an ALTREP vector that points directly at the
+// array's data buffer. The vector holds a reference to the array (via an
+// external pointer using the same finalizer as other Python object
+// references) so that the buffer remains valid for as long as R needs it.
+//
+// R treats vectors as immutable values, so whenever R asks for a writeable
+// data pointer we materialize a private copy of the data and release the
+// NumPy array; subsequent modifications to the R vector are never visible
+// to Python (and vice versa).
+//
+// String arrays are handled similarly, except that each element is decoded
+// into a CHARSXP only when it's first requested by R.
+//
+// The numeric views are not specific to NumPy: any Python object exporting
+// suitably laid out memory (through the buffer protocol, the array interface
+// or DLPack) can be viewed, provided the view holds a Python object whose
+// lifetime keeps that memory valid.
+//
+
+#include "altrep.h"
+
+#define RCPP_NO_MODULES
+#define RCPP_NO_SUGAR
+
+#include <Rcpp.h>
+#include <Rversion.h>
+
+#include "reticulate_types.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <stdint.h>
+
+#if R_VERSION >= R_Version(3, 6, 0)
+# define RETICULATE_HAVE_ALTREP 1
+# include <R_ext/Altrep.h>
+#endif
+
+#if defined(RETICULATE_HAVE_ALTREP) && R_VERSION >= R_Version(4, 1, 0)
+# define RETICULATE_HAVE_ALTCOMPLEX 1
+#endif
+
+using namespace reticulate::libpython;
+
+// defined in python.cpp
+SEXP as_r_charsxp(PyObject* pyStr);
+
+namespace reticulate {
+namespace altrep {
+
+#ifdef RETICULATE_HAVE_ALTREP
+
+namespace {
+
+R_altrep_class_t s_numpy_real;
+R_altrep_class_t s_numpy_integer;
+R_altrep_class_t s_numpy_string;
+#ifdef RETICULATE_HAVE_ALTCOMPLEX
+R_altrep_class_t s_numpy_complex;
+#endif
+
+bool s_registered = false;
+
+template <int RTYPE> struct storage;
+template <> struct storage<REALSXP> { typedef double type; };
+template <> struct storage<INTSXP>  { typedef int type; };
+template <> struct storage<CPLXSXP> { typedef Rcomplex type; };
+
+template <int RTYPE>
+class MemoryView {
+
+public:
+
+  typedef typename storage<RTYPE>::type value_type;
+
+  // data1: external pointer to the viewed memory (cleared once a private
+  //        copy has been made); the tag holds the vector length, and the
+  //        protected value is a reference to the Python object which owns
+  //        the memory (e.g. the NumPy array, or an exported buffer)
+  // data2: R_NilValue, or the materialized copy of the data
+  static SEXP make(R_altrep_class_t klass, PyObject* owner, void* data, R_xlen_t n) {
+
+    SEXP ref = PROTECT(R_MakeExternalPtr((void*) owner, R_NilValue, R_NilValue));
+    Py_IncRef(owner);
+    R_RegisterCFinalizer(ref, python_object_finalize);
+
+    SEXP length = PROTECT(Rf_ScalarReal((double) n));
+    SEXP xptr = PROTECT(R_MakeExternalPtr(data, length, ref));
+
+    SEXP result = R_new_altrep(klass, xptr, R_NilValue);
+    UNPROTECT(3);
+    return result;
+
+  }
+
+  static void* memory(SEXP x) {
+    return R_ExternalPtrAddr(R_altrep_data1(x));
+  }
+
+  static SEXP copy(SEXP x) {
+    return R_altrep_data2(x);
+  }
+
+  static R_xlen_t Length(SEXP x) {
+    SEXP length = R_ExternalPtrTag(R_altrep_data1(x));
+    return (R_xlen_t) REAL(length)[0];
+  }
+
+  static SEXP materialize(SEXP x) {
+
+    R_xlen_t n = Length(x);
+    SEXP materialized = PROTECT(Rf_allocVector(RTYPE, n));
+    std::memcpy(DATAPTR(materialized), memory(x), n * sizeof(value_type));
+    R_set_altrep_data2(x, materialized);
+    UNPROTECT(1);
+
+    // we no longer need the Python object owning the memory; queue it to
+    // be released (see py_decref_later()) rather than waiting for the
+    // garbage collector to notice
+    SEXP xptr = R_altrep_data1(x);
+    SEXP ref = R_ExternalPtrProtected(xptr);
+    python_object_finalize(ref);
+    R_ClearExternalPtr(ref);
+    R_ClearExternalPtr(xptr);
+
+    return materialized;
+
+  }
+
+  static void* Dataptr(SEXP x, Rboolean writeable) {
+
+    SEXP materialized = copy(x);
+    if (materialized != R_NilValue)
+      return DATAPTR(materialized);
+
+    if (writeable)
+      return DATAPTR(materialize(x));
+
+    return memory(x);
+
+  }
+
+  static const void* Dataptr_or_null(SEXP x) {
+    return Dataptr(x, FALSE);
+  }
+
+  static value_type* data(SEXP x) {
+    return (value_type*) Dataptr(x, FALSE);
+  }
+
+  static value_type Elt(SEXP x, R_xlen_t i) {
+    return data(x)[i];
+  }
+
+  static R_xlen_t Get_region(SEXP x, R_xlen_t i, R_xlen_t n, value_type* buf) {
+    R_xlen_t size = Length(x);
+    R_xlen_t ncopy = (size - i > n) ? n : size - i;
+    if (ncopy > 0)
+      std::memcpy(buf, data(x) + i, ncopy * sizeof(value_type));
+    return ncopy;
+  }
+
+  // attributes are copied by R after we return
+  static SEXP Duplicate(SEXP x, Rboolean deep) {
+    R_xlen_t n = Length(x);
+    SEXP result = PROTECT(Rf_allocVector(RTYPE, n));
+    std::memcpy(DATAPTR(result), data(x), n * sizeof(value_type));
+    UNPROTECT(1);
+    return result;
+  }
+
+  static Rboolean Inspect(SEXP x, int pre, int deep, int pvec,
+                          void (*inspect_subtree)(SEXP, int, int, int))
+  {
+    bool materialized = copy(x) != R_NilValue;
+    Rprintf("reticulate memory view (len=%ld, materialized=%s)\n",
+            (long) Length(x), materialized ? "TRUE" : "FALSE");
+    return TRUE;
+  }
+
+  static void registerMethods(R_altrep_class_t klass) {
+    R_set_altrep_Length_method(klass, Length);
+    R_set_altrep_Duplicate_method(klass, Duplicate);
+    R_set_altrep_Inspect_method(klass, Inspect);
+    R_set_altvec_Dataptr_method(klass, Dataptr);
+    R_set_altvec_Dataptr_or_null_method(klass, Dataptr_or_null);
+  }
+
+};
+
+// append the UTF-8 encoding of a code point to a string; invalid code
+// points (surrogates, out of range values) are dropped, matching the
+// "ignore" error handler used when encoding Python strings
+void append_utf8(std::string& out, uint32_t cp) {
+  if (cp < 0x80) {
+    out.push_back((char) cp);
+  } else if (cp < 0x800) {
+    out.push_back((char) (0xC0 | (cp >> 6)));
+    out.push_back((char) (0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    if (cp >= 0xD800 && cp <= 0xDFFF)
+      return;
+    out.push_back((char) (0xE0 | (cp >> 12)));
+    out.push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back((char) (0x80 | (cp & 0x3F)));
+  } else if (cp < 0x110000) {
+    out.push_back((char) (0xF0 | (cp >> 18)));
+    out.push_back((char) (0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back((char) (0x80 | (cp & 0x3F)));
+  }
+}
+
+uint32_t byteswap(uint32_t x) {
+  return ((x & 0x000000FF) << 24) | ((x & 0x0000FF00) << 8) |
+         ((x & 0x00FF0000) >> 8)  | ((x & 0xFF000000) >> 24);
+}
+
+// Character vector backed by a NumPy array of fixed-width strings (dtype
+// 'U' or 'S'), or by an object array containing only strings. Elements are
+// converted to CHARSXPs only when R asks for them.
+class NumpyStringView {
+
+public:
+
+  // data1: external pointer to the viewed PyArrayObject, with the array
+  //        length in the tag
+  // data2: R_NilValue, or the fully materialized character vector
+  static SEXP make(PyArrayObject* array) {
+
+    SEXP length = PROTECT(Rf_ScalarReal((double) PyArray_SIZE(array)));
+    SEXP xptr = PROTECT(R_MakeExternalPtr((void*) array, length, R_NilValue));
+    Py_IncRef((PyObject*) array);
+    R_RegisterCFinalizer(xptr, python_object_finalize);
+
+    SEXP result = R_new_altrep(s_numpy_string, xptr, R_NilValue);
+    UNPROTECT(2);
+    return result;
+
+  }
+
+  static PyArrayObject* array(SEXP x) {
+    return (PyArrayObject*) R_ExternalPtrAddr(R_altrep_data1(x));
+  }
+
+  static R_xlen_t Length(SEXP x) {
+    SEXP length = R_ExternalPtrTag(R_altrep_data1(x));
+    return (R_xlen_t) REAL(length)[0];
+  }
+
+  static bool is_materialized(SEXP x) {
+    return TYPEOF(R_altrep_data2(x)) == STRSXP;
+  }
+
+  // locate the i'th element (in R's column-major order) of the array,
+  // respecting the array's strides so that C-ordered arrays and strided
+  // views can be used without copying
+  static const char* element(PyArrayObject* array, R_xlen_t i) {
+
+    int nd = PyArray_NDIM(array);
+    npy_intp* dims = PyArray_DIMS(array);
+    npy_intp* strides = PyArray_STRIDES(array);
+
+    npy_intp offset = 0;
+    for (int k = 0; k < nd; k++) {
+      offset += (i % dims[k]) * strides[k];
+      i /= dims[k];
+    }
+
+    return (const char*) PyArray_DATA(array) + offset;
+
+  }
+
+  static SEXP decode_unicode(PyArrayObject* array, const char* data) {
+
+    // fixed-width UCS4, padded with trailing NULs
+    PyArray_Descr* descr = PyArray_DESCR(array);
+    bool swap = !PyArray_ISNBO(descr->byteorder);
+    int n = descr->elsize / sizeof(uint32_t);
+
+    std::string out;
+    out.reserve(n);
+    for (int j = 0; j < n; j++) {
+      uint32_t cp;
+      std::memcpy(&cp, data + j * sizeof(uint32_t), sizeof(uint32_t));
+      if (swap)
+        cp = byteswap(cp);
+      if (cp == 0)
+        break;
+      append_utf8(out, cp);
+    }
+
+    return Rf_mkCharLenCE(out.data(), out.size(), CE_UTF8);
+
+  }
+
+  static SEXP decode_bytes(PyArrayObject* array, const char* data) {
+    int n = PyArray_ITEMSIZE(array);
+    const char* end = (const char*) std::memchr(data, '\0', n);
+    int len = end == NULL ? n : end - data;
+    return Rf_mkCharLenCE(data, len, CE_NATIVE);
+  }
+
+  // convert the elements [begin, end) of an object array, storing them in
+  // `out` (unless it is R_NilValue) and returning the last. The GIL is taken
+  // once for all of them, and the elements are only read while it is held,
+  // as another Python thread could otherwise replace (and free) them
+  static SEXP decode_objects(PyArrayObject* array, R_xlen_t begin, R_xlen_t end,
+                             SEXP out)
+  {
+    // no C++ exception may escape into R (which called Elt()), so errors
+    // are caught here and re-raised as R errors once the scope has ended
+    SEXP condition = R_NilValue;
+    char message[8192] = "Error converting Python string to R";
+    try {
+      GILScope scope;
+      SEXP value = NA_STRING;
+      for (R_xlen_t i = begin; i < end; i++) {
+        PyObject* object;
+        std::memcpy(&object, element(array, i), sizeof(PyObject*));
+        value = as_r_charsxp(object);
+        if (out != R_NilValue)
+          SET_STRING_ELT(out, i, value);
+      }
+      return value;
+    } catch (PythonException& e) {
+      condition = e.condition;
+    } catch (std::exception& e) {
+      std::snprintf(message, sizeof(message), "%s", e.what());
+    } catch (...) {
+    }
+
+    if (condition == R_NilValue)
+      Rf_error("%s", message);
+
+    // re-raise as an R error, now that the GIL has been released
+    SEXP call = PROTECT(Rf_lang2(Rf_install("stop"), condition));
+    Rf_eval(call, R_BaseEnv);
+    UNPROTECT(1);
+    return NA_STRING;
+
+  }
+
+  static SEXP decode(PyArrayObject* array, R_xlen_t i) {
+    switch (PyArray_TYPE(array)) {
+    case NPY_UNICODE: return decode_unicode(array, element(array, i));
+    case NPY_STRING:  return decode_bytes(array, element(array, i));
+    default:          return decode_objects(array, i, i + 1, R_NilValue);
+    }
+  }
+
+  // elements are decoded on each access (rather than cached), so that
+  // touching a few strings of a large array costs only those strings; R's
+  // global CHARSXP cache makes repeated decodes return the same CHARSXP
+  static SEXP Elt(SEXP x, R_xlen_t i) {
+
+    SEXP materialized = R_altrep_data2(x);
+    if (materialized != R_NilValue)
+      return STRING_ELT(materialized, i);
+
+    return decode(array(x), i);
+
+  }
+
+  static SEXP materialize(SEXP x) {
+
+    if (is_materialized(x))
+      return R_altrep_data2(x);
+
+    R_xlen_t n = Length(x);
+    PyArrayObject* pArray = array(x);
+    SEXP materialized = PROTECT(Rf_allocVector(STRSXP, n));
+    if (PyArray_TYPE(pArray) == NPY_OBJECT) {
+      decode_objects(pArray, 0, n, materialized);
+    } else {
+      for (R_xlen_t i = 0; i < n; i++)
+        SET_STRING_ELT(materialized, i, decode(pArray, i));
+    }
+    R_set_altrep_data2(x, materialized);
+    UNPROTECT(1);
+
+    SEXP xptr = R_altrep_data1(x);
+    python_object_finalize(xptr);
+    R_ClearExternalPtr(xptr);
+
+    return materialized;
+
+  }
+
+  static void Set_elt(SEXP x, R_xlen_t i, SEXP value) {
+    SET_STRING_ELT(materialize(x), i, value);
+  }
+
+  static void* Dataptr(SEXP x, Rboolean writeable) {
+    return DATAPTR(materialize(x));
+  }
+
+  static const void* Dataptr_or_null(SEXP x) {
+    return is_materialized(x) ? DATAPTR(R_altrep_data2(x)) : NULL;
+  }
+
+  static int No_NA(SEXP x) {
+    if (is_materialized(x))
+      return 0;
+    return PyArray_TYPE(array(x)) != NPY_OBJECT;
+  }
+
+  static Rboolean Inspect(SEXP x, int pre, int deep, int pvec,
+                          void (*inspect_subtree)(SEXP, int, int, int))
+  {
+    Rprintf("reticulate numpy string view (len=%ld, materialized=%s)\n",
+            (long) Length(x), is_materialized(x) ? "TRUE" : "FALSE");
+    return TRUE;
+  }
+
+  static void registerMethods(R_altrep_class_t klass) {
+    R_set_altrep_Length_method(klass, Length);
+    R_set_altrep_Inspect_method(klass, Inspect);
+    R_set_altvec_Dataptr_method(klass, Dataptr);
+    R_set_altvec_Dataptr_or_null_method(klass, Dataptr_or_null);
+    R_set_altstring_Elt_method(klass, Elt);
+    R_set_altstring_Set_elt_method(klass, Set_elt);
+    R_set_altstring_No_NA_method(klass, No_NA);
+  }
+
+};
+
+} // anonymous namespace
+
+void initialize(DllInfo* dll) {
+
+  typedef MemoryView<REALSXP> RealView;
+  s_numpy_real = R_make_altreal_class("numpy_real", "reticulate", dll);
+  RealView::registerMethods(s_numpy_real);
+  R_set_altreal_Elt_method(s_numpy_real, RealView::Elt);
+  R_set_altreal_Get_region_method(s_numpy_real, RealView::Get_region);
+
+  typedef MemoryView<INTSXP> IntegerView;
+  s_numpy_integer = R_make_altinteger_class("numpy_integer", "reticulate", dll);
+  IntegerView::registerMethods(s_numpy_integer);
+  R_set_altinteger_Elt_method(s_numpy_integer, IntegerView::Elt);
+  R_set_altinteger_Get_region_method(s_numpy_integer, IntegerView::Get_region);
+
+  s_numpy_string = R_make_altstring_class("numpy_string", "reticulate", dll);
+  NumpyStringView::registerMethods(s_numpy_string);
+
+#ifdef RETICULATE_HAVE_ALTCOMPLEX
+  typedef MemoryView<CPLXSXP> ComplexView;
+  s_numpy_complex = R_make_altcomplex_class("numpy_complex", "reticulate", dll);
+  ComplexView::registerMethods(s_numpy_complex);
+  R_set_altcomplex_Elt_method(s_numpy_complex, ComplexView::Elt);
+  R_set_altcomplex_Get_region_method(s_numpy_complex, ComplexView::Get_region);
+#endif
+
+  s_registered = true;
+
+}
+
+SEXPTYPE numpy_view_type(PyArrayObject* array) {
+
+  if (!s_registered)
+    return NILSXP;
+
+  // empty arrays are cheap to copy
+  if (PyArray_SIZE(array) == 0)
+    return NILSXP;
+
+  // strings are decoded on access, so any layout will do (object arrays
+  // must be contiguous as the caller needs to check that they only
+  // contain strings)
+  PyArray_Descr* descr = PyArray_DESCR(array);
+  switch (descr->type_num) {
+  case NPY_UNICODE:
+  case NPY_STRING:
+    return STRSXP;
+  case NPY_OBJECT:
+    return (PyArray_FLAGS(array) & NPY_ARRAY_FARRAY_RO) == NPY_ARRAY_FARRAY_RO
+      ? STRSXP
+      : NILSXP;
+  }
+
+  // the memory must be laid out exactly as R would lay it out
+  int required = NPY_ARRAY_F_CONTIGUOUS | NPY_ARRAY_ALIGNED;
+  if ((PyArray_FLAGS(array) & required) != required)
+    return NILSXP;
+
+  if (!PyArray_ISNBO(descr->byteorder))
+    return NILSXP;
+
+  switch (descr->type_num) {
+
+  case NPY_DOUBLE:
+    return descr->elsize == sizeof(double) ? REALSXP : NILSXP;
+
+  // NPY_LONG is 32 bits on Windows
+  case NPY_INT:
+  case NPY_LONG:
+    return descr->elsize == sizeof(int) ? INTSXP : NILSXP;
+
+#ifdef RETICULATE_HAVE_ALTCOMPLEX
+  case NPY_CDOUBLE:
+    return descr->elsize == sizeof(Rcomplex) ? CPLXSXP : NILSXP;
+#endif
+
+  default:
+    return NILSXP;
+
+  }
+
+}
+
+SEXP numpy_view(PyArrayObject* array, SEXPTYPE type) {
+
+  if (type == STRSXP)
+    return NumpyStringView::make(array);
+
+  return memory_view((PyObject*) array, PyArray_DATA(array),
+                     (R_xlen_t) PyArray_SIZE(array), type);
+
+}
+
+bool memory_view_available(SEXPTYPE type) {
+
+  if (!s_registered)
+    return false;
+
+  switch (type) {
+  case REALSXP:
+  case INTSXP:
+    return true;
+#ifdef RETICULATE_HAVE_ALTCOMPLEX
+  case CPLXSXP:
+    return true;
+#endif
+  default:
+    return false;
+  }
+
+}
+
+SEXP memory_view(PyObject* owner, void* data, R_xlen_t n, SEXPTYPE type) {
+
+  switch (type) {
+  case REALSXP: return MemoryView<REALSXP>::make(s_numpy_real, owner, data, n);
+  case INTSXP:  return MemoryView<INTSXP>::make(s_numpy_integer, owner, data, n);
+#ifdef RETICULATE_HAVE_ALTCOMPLEX
+  case CPLXSXP: return MemoryView<CPLXSXP>::make(s_numpy_complex, owner, data, n);
+#endif
+  default: Rcpp::stop("internal error: unsupported memory view type");
+  }
+
+}
+
+#else
+
+void initialize(DllInfo* dll) {}
+
+SEXPTYPE numpy_view_type(PyArrayObject* array) {
+  return NILSXP;
+}
+
+SEXP numpy_view(PyArrayObject* array, SEXPTYPE type) {
+  Rcpp::stop("internal error: ALTREP is not available");
+}
+
+bool memory_view_available(SEXPTYPE type) {
+  return false;
+}
+
+SEXP memory_view(PyObject* owner, void* data, R_xlen_t n, SEXPTYPE type) {
+  Rcpp::stop("internal error: ALTREP is not available");
+}
+
+#endif
+
+} // namespace altrep
+} // namespace reticulate
+
+// [[Rcpp::init]]
+void reticulate_init_altrep(DllInfo* dll) {
+  reticulate::altrep::initialize(dll);
+}
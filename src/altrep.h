@@ -0,0 +1,36 @@
+#ifndef RETICULATE_ALTREP_H
+#define RETICULATE_ALTREP_H
+
+#include "libpython.h"
+
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+
+namespace reticulate {
+namespace altrep {
+
+// register the ALTREP classes provided by reticulate
+void initialize(DllInfo* dll);
+
+// the R vector type that can be used to view the memory of a NumPy array
+// directly, or NILSXP if the array must be copied in conversion
+SEXPTYPE numpy_view_type(libpython::PyArrayObject* array);
+
+// create an R vector of the requested type which views the memory of a
+// NumPy array (the array is kept alive until the vector is collected, or
+// until R requests a writeable pointer and a private copy is made)
+SEXP numpy_view(libpython::PyArrayObject* array, SEXPTYPE type);
+
+// can memory of the given R vector type (REALSXP, INTSXP or CPLXSXP) be
+// viewed with memory_view()?
+bool memory_view_available(SEXPTYPE type);
+
+// create an R vector of length n which views memory laid out exactly as R
+// would lay out a vector of the requested type; 'owner' is retained by the
+// vector and must keep the memory valid for as long as it is alive
+SEXP memory_view(libpython::PyObject* owner, void* data, R_xlen_t n, SEXPTYPE type);
+
+} // namespace altrep
+} // namespace reticulate
+
+#endif // RETICULATE_ALTREP_H
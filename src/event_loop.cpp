@@ -21,6 +21,13 @@
 // time wise and in terms of only scheduling an additional callback while the
 // Python interpreter remains running).
 //
+// The background thread parks itself whenever a requested poll has not run
+// by the time it next wakes (meaning that the interpreter is no longer
+// running Python code), and is woken up again by that same poll, which runs
+// as soon as Python code is next executed. While Python code keeps running,
+// the interval between polls starts short (for responsive interrupts right
+// after entering Python) and doubles up to a configurable maximum.
+//
 
 #include "event_loop.h"
 #include "common.h"
@@ -28,9 +35,13 @@
 #include "libpython.h"
 using namespace reticulate::libpython;
 
+#include "main_thread.h"
 #include "signals.h"
 #include "tinythread.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace reticulate {
 namespace event_loop {
 
@@ -40,30 +51,64 @@ namespace {
 volatile sig_atomic_t s_pollingRequested;
 bool s_flush_std_buffers = true;
 
+// The shortest and longest intervals between polls.
+int s_minIntervalMs = 25;
+int s_maxIntervalMs = 200;
+
+// Is the background thread parked (waiting for Python code to run)?
+tthread::mutex s_mutex;
+tthread::condition_variable s_unparked;
+bool s_parked = false;
+
+// the counters reported by stats(); the polling thread updates the first
+// two, and the main thread the others
+std::atomic<unsigned long> s_wakeups(0);
+std::atomic<unsigned long> s_parks(0);
+std::atomic<unsigned long> s_polls(0);
+std::atomic<unsigned long> s_flushes(0);
+
 // Forward declarations
 int pollForEvents(void*);
 
 // Background thread which re-schedules pollForEvents on the main Python
 // interpreter thread so long as the Python interpeter is still running
 // (when it stops running it will stop calling pollForEvents and
-// the polling signal will not be set).
+// the polling signal will not be set, and the thread parks itself).
 void eventPollingWorker(void *) {
 
+  int intervalMs = s_minIntervalMs;
+
   while (true) {
 
     // Throttle via sleep
-    tthread::this_thread::sleep_for(tthread::chrono::milliseconds(200));
+    tthread::this_thread::sleep_for(tthread::chrono::milliseconds(intervalMs));
+    s_wakeups++;
+
+    // If the previous poll hasn't run yet, Python code isn't running: park
+    // until that poll runs (when Python code is next executed).
+    if (s_pollingRequested != 0)
+    {
+      tthread::lock_guard<tthread::mutex> guard(s_mutex);
+      if (s_pollingRequested != 0) {
+        s_parked = true;
+        s_parks++;
+        while (s_parked)
+          s_unparked.wait(s_mutex);
+      }
+      intervalMs = s_minIntervalMs;
+      continue;
+    }
 
     // Schedule polling on the main thread if the interpeter is still running.
     // Note that Py_AddPendingCall is documented to be callable from a background
     // thread: "This function doesn’t need a current thread state to run, and it
     // doesn’t need the global interpreter lock."
     // (see: https://docs.python.org/3/c-api/init.html#c.Py_AddPendingCall)
-    if (s_pollingRequested == 0)
-    {
-      s_pollingRequested = 1;
-      Py_AddPendingCall(pollForEvents, NULL);
-    }
+    s_pollingRequested = 1;
+    Py_AddPendingCall(pollForEvents, NULL);
+
+    // Python is (still) running, so back off towards the longest interval.
+    intervalMs = std::min(intervalMs * 2, s_maxIntervalMs);
 
   }
 
@@ -82,15 +127,24 @@ void processEvents(void* data) {
 int pollForEvents(void*) {
 
   DBG("Polling for events.");
+  s_polls++;
 
   // Request that the background thread schedule us to be called again
   // (this is delegated to a background thread so that these requests
-  // can be throttled)
-  s_pollingRequested = 0;
+  // can be throttled), waking it up if it has parked itself
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_mutex);
+    s_pollingRequested = 0;
+    if (s_parked) {
+      s_parked = false;
+      s_unparked.notify_one();
+    }
+  }
 
   // Periodically flush stdout/stderr buffers to ensure that any output from
   // long-running Python calls is visible in the R console.
-  if (s_flush_std_buffers) {
+  if (s_flush_std_buffers && (std_buffer_needs_flush("stdout") || std_buffer_needs_flush("stderr"))) {
+    s_flushes++;
     if (flush_std_buffers() != 0) {
       Rprintf("Error flushing Python's stdout/stderr buffers. Auto-flushing is now disabled.\n");
       s_flush_std_buffers = false;
@@ -104,17 +158,34 @@ int pollForEvents(void*) {
     R_ToplevelExec(processEvents, NULL);
   }
 
-  // Success!
-  return 0;
+  // Run any tasks queued for the main thread, in case the pending call to
+  // run them could not be scheduled.
+  return main_thread::drain();
 
 }
 
 } // anonymous namespace
 
 // Initialize event loop polling background thread
-void initialize() {
+void initialize(int intervalMs) {
+
+  if (intervalMs > 0) {
+    s_maxIntervalMs = intervalMs;
+    s_minIntervalMs = std::min(s_minIntervalMs, intervalMs);
+  }
+
   tthread::thread t(eventPollingWorker, NULL);
   t.detach();
+
+}
+
+Stats stats() {
+  Stats stats;
+  stats.wakeups = s_wakeups;
+  stats.parks = s_parks;
+  stats.polls = s_polls;
+  stats.flushes = s_flushes;
+  return stats;
 }
 
 } // namespace event_loop
@@ -1,11 +1,23 @@
-
 #ifndef RETICULATE_EVENT_LOOP_H
 #define RETICULATE_EVENT_LOOP_H
 
 namespace reticulate {
 namespace event_loop {
 
-void initialize();
+// start polling for events while Python code runs, at most every
+// 'intervalMs' milliseconds (or the default of 200ms, when <= 0)
+void initialize(int intervalMs = 0);
+
+// counts of the event loop's activity, for tuning the polling interval
+struct Stats {
+  Stats() : wakeups(0), parks(0), polls(0), flushes(0) {}
+  double wakeups;  // times the polling thread woke up
+  double parks;    // times it parked, as Python code wasn't running
+  double polls;    // polls for events run on the main thread
+  double flushes;  // flushes of Python's stdout and stderr
+};
+
+Stats stats();
 
 } // namespace event_loop
 } // namespace reticulate
@@ -9,6 +9,11 @@
 #include <windows.h>
 #endif
 
+#include <R_ext/Print.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -129,6 +134,44 @@ bool loadSymbol(void* pLib, const std::vector<std::string>& names, void** ppSymb
   return false;
 }
 
+// Rarely used functions are bound the first time they're called, rather
+// than when the library is loaded: until then, each points at a stub which
+// looks up the function, rebinds the pointer to it, and forwards the call.
+// Only functions called on the main thread are deferred (functions which
+// may be reached from other Python threads, e.g. by R callbacks or capsule
+// destructors, are bound eagerly), so that the pointers are never rebound
+// while another thread reads them.
+void* s_pDeferredLib = NULL;
+
+std::map<void**, const char*>& deferredSymbols() {
+  static std::map<void**, const char*> symbols;
+  return symbols;
+}
+
+// the stub may be called from frames (C++, or Python's) which an R error
+// can't safely unwind, and the function is part of the library's API (so
+// failing to find it means the library is broken): abort
+void bindDeferredSymbol(void** ppSymbol) {
+  const char* name = deferredSymbols()[ppSymbol];
+  std::string error;
+  if (!loadSymbol(s_pDeferredLib, name, ppSymbol, &error)) {
+    REprintf("Fatal error: unable to bind Python library function %s (%s)\n",
+             name, error.c_str());
+    std::abort();
+  }
+}
+
+template <typename Fn, Fn* Ptr>
+struct Deferred;
+
+template <typename R, typename... Args, R (**Ptr)(Args...)>
+struct Deferred<R (*)(Args...), Ptr> {
+  static R stub(Args... args) {
+    bindDeferredSymbol((void**) Ptr);
+    return (*Ptr)(args...);
+  }
+};
+
 } // anonymous namespace
 
 
@@ -162,6 +205,10 @@ if (!loadSymbol(pLib_, #name, (void**)&as, pError)) \
 if (!loadSymbol(pLib_, #name, (void**) &libpython::name, pError)) \
   return false;
 
+#define DEFER_PYTHON_SYMBOL(name)                                         \
+deferredSymbols()[(void**) &libpython::name] = #name;                     \
+libpython::name = &Deferred<decltype(libpython::name), &libpython::name>::stub;
+
 bool SharedLibrary::load(const std::string& libPath, bool python3, std::string* pError)
 {
   if (!loadLibrary(libPath, &pLib_, pError))
@@ -174,6 +221,7 @@ bool SharedLibrary::load(const std::string& libPath, bool python3, std::string*
 bool LibPython::loadSymbols(bool python3, std::string* pError)
 {
   bool is64bit = sizeof(size_t) >= 8;
+  s_pDeferredLib = pLib_;
 
   LOAD_PYTHON_SYMBOL(Py_Initialize)
   LOAD_PYTHON_SYMBOL(Py_IsInitialized)
@@ -192,6 +240,7 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
   LOAD_PYTHON_SYMBOL(PyObject_SetAttr)
   LOAD_PYTHON_SYMBOL(PyObject_GetAttrString)
   LOAD_PYTHON_SYMBOL(PyObject_HasAttrString)
+  LOAD_PYTHON_SYMBOL(PyObject_GenericGetAttr)
   LOAD_PYTHON_SYMBOL(PyObject_SetAttrString)
   LOAD_PYTHON_SYMBOL(PyObject_GetItem)
   LOAD_PYTHON_SYMBOL(PyObject_SetItem)
@@ -211,21 +260,22 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
   LOAD_PYTHON_SYMBOL(PyErr_Restore)
   LOAD_PYTHON_SYMBOL(PyErr_Occurred)
   LOAD_PYTHON_SYMBOL(PyErr_SetNone)
+  LOAD_PYTHON_SYMBOL(PyErr_SetObject)
   LOAD_PYTHON_SYMBOL(PyErr_BadArgument)
   LOAD_PYTHON_SYMBOL(PyErr_NormalizeException)
   LOAD_PYTHON_SYMBOL(PyErr_ExceptionMatches)
   LOAD_PYTHON_SYMBOL(PyErr_GivenExceptionMatches)
   LOAD_PYTHON_SYMBOL(PyErr_PrintEx)
-  LOAD_PYTHON_SYMBOL(PyObject_Print)
+  DEFER_PYTHON_SYMBOL(PyObject_Print)
   LOAD_PYTHON_SYMBOL(PyObject_Str)
   LOAD_PYTHON_SYMBOL(PyObject_Repr)
-  LOAD_PYTHON_SYMBOL(PyObject_Dir)
-  LOAD_PYTHON_SYMBOL(PyByteArray_Size)
+  DEFER_PYTHON_SYMBOL(PyObject_Dir)
+  DEFER_PYTHON_SYMBOL(PyByteArray_Size)
   LOAD_PYTHON_SYMBOL(PyByteArray_FromStringAndSize)
-  LOAD_PYTHON_SYMBOL(PyByteArray_AsString)
+  DEFER_PYTHON_SYMBOL(PyByteArray_AsString)
   LOAD_PYTHON_SYMBOL(PyCallable_Check)
   LOAD_PYTHON_SYMBOL(PyRun_StringFlags)
-  LOAD_PYTHON_SYMBOL(PyRun_FileEx)
+  DEFER_PYTHON_SYMBOL(PyRun_FileEx)
   LOAD_PYTHON_SYMBOL(PyEval_EvalCode)
   LOAD_PYTHON_SYMBOL(PyModule_GetDict)
   LOAD_PYTHON_SYMBOL(PyImport_AddModule)
@@ -235,18 +285,22 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
   LOAD_PYTHON_SYMBOL(PyObject_GetIter)
   LOAD_PYTHON_SYMBOL(PyIter_Next)
   LOAD_PYTHON_SYMBOL(PyLong_AsLong)
+  LOAD_PYTHON_SYMBOL(PyLong_AsSsize_t)
   LOAD_PYTHON_SYMBOL(PyLong_FromLong)
-  LOAD_PYTHON_SYMBOL(PySlice_New)
+  LOAD_PYTHON_SYMBOL(PyLong_AsVoidPtr)
+  LOAD_PYTHON_SYMBOL(PyLong_FromVoidPtr)
+  DEFER_PYTHON_SYMBOL(PySlice_New)
   LOAD_PYTHON_SYMBOL(PyBool_FromLong)
   LOAD_PYTHON_SYMBOL(PyDict_New)
   LOAD_PYTHON_SYMBOL(PyDict_Contains)
   LOAD_PYTHON_SYMBOL(PyDict_GetItem)
+  LOAD_PYTHON_SYMBOL(PyDict_GetItemString)
   LOAD_PYTHON_SYMBOL(PyDict_SetItem)
   LOAD_PYTHON_SYMBOL(PyDict_SetItemString)
-  LOAD_PYTHON_SYMBOL(PyDict_DelItemString)
+  DEFER_PYTHON_SYMBOL(PyDict_DelItemString)
   LOAD_PYTHON_SYMBOL(PyDict_Next)
   LOAD_PYTHON_SYMBOL(PyDict_Keys)
-  LOAD_PYTHON_SYMBOL(PyDict_Values)
+  DEFER_PYTHON_SYMBOL(PyDict_Values)
   LOAD_PYTHON_SYMBOL(PyDict_Size)
   LOAD_PYTHON_SYMBOL(PyDict_Copy)
   LOAD_PYTHON_SYMBOL(PyFloat_AsDouble)
@@ -257,23 +311,26 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
   LOAD_PYTHON_SYMBOL(PyType_Type)
   LOAD_PYTHON_SYMBOL(PyProperty_Type)
   LOAD_PYTHON_SYMBOL(PyCapsule_IsValid)
+  DEFER_PYTHON_SYMBOL(PyCapsule_SetName)
   LOAD_PYTHON_SYMBOL(PyComplex_FromDoubles)
-  LOAD_PYTHON_SYMBOL(PyComplex_RealAsDouble)
-  LOAD_PYTHON_SYMBOL(PyComplex_ImagAsDouble)
+  DEFER_PYTHON_SYMBOL(PyComplex_RealAsDouble)
+  DEFER_PYTHON_SYMBOL(PyComplex_ImagAsDouble)
   LOAD_PYTHON_SYMBOL(PyObject_IsInstance)
   LOAD_PYTHON_SYMBOL(PyObject_RichCompareBool)
   LOAD_PYTHON_SYMBOL(PyObject_Call)
   LOAD_PYTHON_SYMBOL(PyObject_CallFunctionObjArgs)
   LOAD_PYTHON_SYMBOL(PyType_IsSubtype)
   LOAD_PYTHON_SYMBOL(PyType_GetFlags)
-  LOAD_PYTHON_SYMBOL(PyMapping_Items)
+  DEFER_PYTHON_SYMBOL(PyMapping_Items)
   LOAD_PYTHON_SYMBOL(PySys_WriteStderr)
   LOAD_PYTHON_SYMBOL(PySys_GetObject)
-  LOAD_PYTHON_SYMBOL(PyEval_SetProfile)
+  DEFER_PYTHON_SYMBOL(PyEval_SetProfile)
   LOAD_PYTHON_SYMBOL(PyGILState_GetThisThreadState)
   LOAD_PYTHON_SYMBOL(PyGILState_Ensure)
   LOAD_PYTHON_SYMBOL(PyGILState_Release)
   LOAD_PYTHON_SYMBOL(PyThreadState_Next)
+  LOAD_PYTHON_SYMBOL(PyEval_SaveThread)
+  LOAD_PYTHON_SYMBOL(PyEval_RestoreThread)
   LOAD_PYTHON_SYMBOL(PyObject_CallMethod)
   LOAD_PYTHON_SYMBOL(PySequence_GetItem)
   LOAD_PYTHON_SYMBOL(PyObject_IsTrue)
@@ -290,7 +347,7 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
     return false;
 
   if (python3) {
-    LOAD_PYTHON_SYMBOL(PyException_SetTraceback)
+    DEFER_PYTHON_SYMBOL(PyException_SetTraceback)
     LOAD_PYTHON_SYMBOL(Py_GetProgramFullPath)
 
     // Debug versions of Python will provide PyModule_Create2TraceRefs,
@@ -305,16 +362,30 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
     LOAD_PYTHON_SYMBOL_AS(Py_SetProgramName, Py_SetProgramName_v3)
     LOAD_PYTHON_SYMBOL_AS(Py_SetPythonHome, Py_SetPythonHome_v3)
     LOAD_PYTHON_SYMBOL_AS(PySys_SetArgv, PySys_SetArgv_v3)
-    LOAD_PYTHON_SYMBOL(PyUnicode_EncodeLocale)
+    DEFER_PYTHON_SYMBOL(PyUnicode_EncodeLocale)
 #ifdef _WIN32
     LOAD_PYTHON_SYMBOL(PyUnicode_AsMBCSString)
 #endif
+    LOAD_PYTHON_SYMBOL(PyObject_GetBuffer)
+    LOAD_PYTHON_SYMBOL(PyBuffer_Release)
     LOAD_PYTHON_SYMBOL(PyBytes_AsStringAndSize)
     LOAD_PYTHON_SYMBOL(PyBytes_FromStringAndSize)
     LOAD_PYTHON_SYMBOL(PyUnicode_FromString)
+    LOAD_PYTHON_SYMBOL(PyUnicode_FromStringAndSize)
+    LOAD_PYTHON_SYMBOL(PyUnicode_AsUTF8AndSize)
     LOAD_PYTHON_SYMBOL_AS(PyLong_AsLong, PyInt_AsLong)
     LOAD_PYTHON_SYMBOL_AS(PyLong_FromLong, PyInt_FromLong)
     LOAD_PYTHON_SYMBOL(Py_CompileStringExFlags)
+
+    // optional (Python >= 3.9)
+    std::string ignored;
+    loadSymbol(pLib_, "PyObject_Vectorcall", (void**) &PyObject_Vectorcall, &ignored);
+
+    // optional (removed in Python 3.13, and a no-op since Python 3.7)
+    loadSymbol(pLib_, "PyEval_InitThreads", (void**) &PyEval_InitThreads, &ignored);
+
+    // optional (Python >= 3.4)
+    loadSymbol(pLib_, "PyGILState_Check", (void**) &PyGILState_Check, &ignored);
   } else {
     if (is64bit) {
       LOAD_PYTHON_SYMBOL_AS(Py_InitModule4_64, Py_InitModule4)
@@ -332,7 +403,9 @@ bool LibPython::loadSymbols(bool python3, std::string* pError)
     LOAD_PYTHON_SYMBOL(PyInt_FromLong)
     LOAD_PYTHON_SYMBOL(PyCObject_AsVoidPtr)
     LOAD_PYTHON_SYMBOL(Py_CompileString)
+    LOAD_PYTHON_SYMBOL(PyEval_InitThreads)
   }
+  LOAD_PYTHON_SYMBOL(PyCFunction_NewEx)
   LOAD_PYTHON_SYMBOL(PyCapsule_New)
   LOAD_PYTHON_SYMBOL(PyCapsule_GetPointer)
   LOAD_PYTHON_SYMBOL(PyCapsule_SetContext)
@@ -400,35 +473,51 @@ bool import_numpy_api(bool python3, std::string* pError) {
 }
 
 
+bool std_buffer_needs_flush(const char* name) {
+
+  PyObject* stream = PySys_GetObject(name);  // returns borrowed reference
+  if (stream == NULL)
+    return true;
+
+  const char* type = Py_TYPE(stream)->tp_name;
+  return
+    std::strcmp(type, "OutputRemap") != 0 &&
+    std::strcmp(type, "_io.StringIO") != 0 &&
+    std::strcmp(type, "StringIO") != 0;
+
+}
+
+namespace {
+
+int flush_std_buffer(const char* name) {
+
+  if (!std_buffer_needs_flush(name))
+    return 0;
+
+  PyObject* stream(PySys_GetObject(name));  // returns borrowed reference
+  if (stream == NULL)
+    return -1;
+
+  PyObject* result = PyObject_CallMethod(stream, "flush", NULL);
+  if (result == NULL)
+    return -1;
+
+  Py_DecRef(result);
+  return 0;
+
+}
+
+} // end anonymous namespace
+
 int flush_std_buffers() {
-  int status = 0;
-  PyObject* tmp = NULL;
   PyObject *error_type, *error_value, *error_traceback;
   PyErr_Fetch(&error_type, &error_value, &error_traceback);
 
-  PyObject* sys_stdout(PySys_GetObject("stdout"));  // returns borrowed reference
-  if (sys_stdout == NULL)
-    status = -1;
-  else
-    tmp = PyObject_CallMethod(sys_stdout, "flush", NULL);
-
-  if (tmp == NULL)
-    status = -1;
-  else {
-    Py_DecRef(tmp);
-    tmp = NULL;
-  }
-
-  PyObject* sys_stderr(PySys_GetObject("stderr"));  // returns borrowed reference
-  if (sys_stderr == NULL)
+  int status = 0;
+  if (flush_std_buffer("stdout") == -1)
     status = -1;
-  else
-    tmp = PyObject_CallMethod(sys_stderr, "flush", NULL);
-
-  if (tmp == NULL)
+  if (flush_std_buffer("stderr") == -1)
     status = -1;
-  else
-    Py_DecRef(tmp);
 
   PyErr_Restore(error_type, error_value, error_traceback);
   return status;
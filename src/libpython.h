@@ -68,6 +68,38 @@ typedef struct _object {
 PyObject_HEAD
 } PyObject;
 
+// the leading fields of PyTypeObject, up to and including the version tag
+// used by Python's method cache (these have been laid out identically
+// since Python 2.6)
+typedef struct {
+PyObject_VAR_HEAD
+  const char *tp_name;
+  Py_ssize_t tp_basicsize, tp_itemsize;
+  void *tp_slots[42];  // tp_dealloc ... tp_del
+  unsigned int tp_version_tag;
+} PyTypeObject_fields;
+
+// the leading fields of Python 3 strings (PyASCIIObject, as laid out since
+// Python 3.3, see PEP 393); they are followed by a wchar_t* in Python < 3.12
+typedef struct {
+PyObject_HEAD
+  Py_ssize_t length;
+  Py_ssize_t hash;
+  struct {
+    unsigned int interned:2;
+    unsigned int kind:3;
+    unsigned int compact:1;
+    unsigned int ascii:1;
+    unsigned int ready:1;  // statically_allocated, as of Python 3.12
+    unsigned int :24;
+  } state;
+} PyASCIIObject_fields;
+
+#define PyUnicode_1BYTE_KIND 1
+
+#define Py_TPFLAGS_VALID_VERSION_TAG    (1UL << 19)
+#define Py_TPFLAGS_MANAGED_DICT         (1UL << 4)   // Python >= 3.11
+
 typedef PyObject *(*PyCFunction)(PyObject *, PyObject *);
 
 struct PyMethodDef {
@@ -240,6 +272,13 @@ LIBPYTHON_EXTERN PyObject* (*PyObject_Dir)(PyObject *);
 
 LIBPYTHON_EXTERN PyObject* (*PyObject_Call)(PyObject *callable_object,
            PyObject *args, PyObject *kw);
+
+// only available as a function with Python >= 3.9 (NULL otherwise)
+LIBPYTHON_EXTERN PyObject* (*PyObject_Vectorcall)(PyObject *callable,
+                                                  PyObject *const *args,
+                                                  size_t nargsf,
+                                                  PyObject *kwnames);
+#define PY_VECTORCALL_ARGUMENTS_OFFSET ((size_t) 1 << (8 * sizeof(size_t) - 1))
 LIBPYTHON_EXTERN PyObject* (*PyObject_CallFunctionObjArgs)(PyObject *callable,
            ...);
 
@@ -250,6 +289,7 @@ LIBPYTHON_EXTERN int (*PyObject_SetAttr)(PyObject*, PyObject*, PyObject*);
 
 LIBPYTHON_EXTERN PyObject* (*PyObject_GetAttrString)(PyObject*, const char *);
 LIBPYTHON_EXTERN int (*PyObject_HasAttrString)(PyObject*, const char *);
+LIBPYTHON_EXTERN PyObject* (*PyObject_GenericGetAttr)(PyObject*, PyObject*);
 LIBPYTHON_EXTERN int (*PyObject_SetAttrString)(PyObject*, const char *, PyObject*);
 
 LIBPYTHON_EXTERN PyObject* (*PyObject_GetItem)(PyObject*, PyObject*);
@@ -288,6 +328,7 @@ LIBPYTHON_EXTERN int (*PyBytes_AsStringAndSize)(
   strings) */
 );
 LIBPYTHON_EXTERN const char* (*PyUnicode_AsUTF8)(PyObject *unicode);
+LIBPYTHON_EXTERN const char* (*PyUnicode_AsUTF8AndSize)(PyObject *unicode, Py_ssize_t *size);
 
 #ifdef _WIN32
 LIBPYTHON_EXTERN PyObject* (*PyUnicode_AsMBCSString)(PyObject *unicode);
@@ -298,6 +339,7 @@ LIBPYTHON_EXTERN Py_ssize_t (*PyByteArray_Size)(PyObject *bytearray);
 LIBPYTHON_EXTERN PyObject* (*PyByteArray_FromStringAndSize)(const char *string, Py_ssize_t len);
 LIBPYTHON_EXTERN char* (*PyByteArray_AsString)(PyObject *bytearray);
 LIBPYTHON_EXTERN PyObject* (*PyUnicode_FromString)(const char *u);
+LIBPYTHON_EXTERN PyObject* (*PyUnicode_FromStringAndSize)(const char *u, Py_ssize_t size);
 
 LIBPYTHON_EXTERN void (*PyErr_Clear)();
 LIBPYTHON_EXTERN void (*PyErr_Print)();
@@ -306,6 +348,7 @@ LIBPYTHON_EXTERN void (*PyErr_PrintEx)(int set_sys_last_vars);
 LIBPYTHON_EXTERN void (*PyErr_Fetch)(PyObject **, PyObject **, PyObject **);
 LIBPYTHON_EXTERN void (*PyErr_Restore)(PyObject *, PyObject *, PyObject *);
 LIBPYTHON_EXTERN void (*PyErr_SetNone)(PyObject*);
+LIBPYTHON_EXTERN void (*PyErr_SetObject)(PyObject*, PyObject*);
 LIBPYTHON_EXTERN void (*PyErr_BadArgument)();
 LIBPYTHON_EXTERN PyObject* (*PyErr_Occurred)(void);
 LIBPYTHON_EXTERN void (*PyErr_NormalizeException)(PyObject**, PyObject**, PyObject**);
@@ -327,16 +370,55 @@ LIBPYTHON_EXTERN PyObject* (*PyObject_GetIter)(PyObject *);
 LIBPYTHON_EXTERN PyObject* (*PyIter_Next)(PyObject *);
 
 typedef void (*PyCapsule_Destructor)(PyObject *);
+LIBPYTHON_EXTERN PyObject* (*PyCFunction_NewEx)(PyMethodDef *ml, PyObject *self, PyObject *module);
 LIBPYTHON_EXTERN PyObject* (*PyCapsule_New)(void *pointer, const char *name, PyCapsule_Destructor destructor);
 LIBPYTHON_EXTERN void* (*PyCapsule_GetPointer)(PyObject *capsule, const char *name);
 LIBPYTHON_EXTERN void* (*PyCapsule_GetContext)(PyObject *capsule);
 LIBPYTHON_EXTERN int (*PyCapsule_SetContext)(PyObject *capsule, void *context);
 LIBPYTHON_EXTERN int (*PyCapsule_IsValid)(PyObject *capsule, const char *name);
+LIBPYTHON_EXTERN int (*PyCapsule_SetName)(PyObject *capsule, const char *name);
+
+// the buffer protocol (Python 3 only, as the Python 2 layout of Py_buffer
+// differs)
+typedef struct {
+  void *buf;
+  PyObject *obj;
+  Py_ssize_t len;
+  Py_ssize_t itemsize;
+  int readonly;
+  int ndim;
+  char *format;
+  Py_ssize_t *shape;
+  Py_ssize_t *strides;
+  Py_ssize_t *suboffsets;
+  void *internal;
+} Py_buffer;
+
+typedef struct {
+  void *bf_getbuffer;
+  void *bf_releasebuffer;
+} PyBufferProcs;
+
+#define PyBUF_SIMPLE 0
+#define PyBUF_FORMAT 0x0004
+#define PyBUF_ND 0x0008
+#define PyBUF_STRIDES (0x0010 | PyBUF_ND)
+#define PyBUF_RECORDS_RO (PyBUF_STRIDES | PyBUF_FORMAT)
+
+// tp_as_buffer is the 15th slot of PyTypeObject (PyObject_CheckBuffer()
+// is only a function as of Python 3.9)
+#define PyObject_CheckBuffer(o)                                                \
+  (((PyTypeObject_fields*) Py_TYPE(o))->tp_slots[14] != NULL &&                 \
+   ((PyBufferProcs*) ((PyTypeObject_fields*) Py_TYPE(o))->tp_slots[14])->bf_getbuffer != NULL)
+
+LIBPYTHON_EXTERN int (*PyObject_GetBuffer)(PyObject *exporter, Py_buffer *view, int flags);
+LIBPYTHON_EXTERN void (*PyBuffer_Release)(Py_buffer *view);
 
 
 LIBPYTHON_EXTERN PyObject* (*PyDict_New)(void);
 LIBPYTHON_EXTERN int (*PyDict_Contains)(PyObject *mp, PyObject *key);
 LIBPYTHON_EXTERN PyObject* (*PyDict_GetItem)(PyObject *mp, PyObject *key);
+LIBPYTHON_EXTERN PyObject* (*PyDict_GetItemString)(PyObject *mp, const char *key);
 LIBPYTHON_EXTERN int (*PyDict_SetItem)(PyObject *mp, PyObject *key, PyObject *item);
 LIBPYTHON_EXTERN int (*PyDict_SetItemString)(PyObject *dp, const char *key, PyObject *item);
 LIBPYTHON_EXTERN int (*PyDict_DelItemString)(PyObject *dp, const char *key);
@@ -352,6 +434,9 @@ LIBPYTHON_EXTERN PyObject* (*PyInt_FromLong)(long);
 LIBPYTHON_EXTERN long (*PyInt_AsLong)(PyObject *);
 LIBPYTHON_EXTERN PyObject* (*PyLong_FromLong)(long);
 LIBPYTHON_EXTERN long (*PyLong_AsLong)(PyObject *);
+LIBPYTHON_EXTERN Py_ssize_t (*PyLong_AsSsize_t)(PyObject *);
+LIBPYTHON_EXTERN void* (*PyLong_AsVoidPtr)(PyObject *);
+LIBPYTHON_EXTERN PyObject* (*PyLong_FromVoidPtr)(void *);
 LIBPYTHON_EXTERN PyObject* (*PySlice_New)(PyObject *start, PyObject *stop, PyObject *step);
 
 LIBPYTHON_EXTERN PyObject* (*PyBool_FromLong)(long);
@@ -444,6 +529,8 @@ typedef long npy_long;
 typedef double npy_double;
 typedef struct { double real, imag; } npy_cdouble;
 typedef npy_cdouble npy_complex128;
+typedef struct { float real, imag; } npy_cfloat;
+typedef npy_cfloat npy_complex64;
 
 typedef intptr_t npy_intp;
 
@@ -552,6 +639,10 @@ LIBPYTHON_EXTERN void **PyArray_API;
           (*(PyObject * (*)(PyTypeObject *, int, npy_intp *, int, npy_intp *, void *, int, int, PyObject *)) \
              PyArray_API[93])
 
+#define PyArray_CopyInto                               \
+          (*(int (*)(PyArrayObject *, PyArrayObject *)) \
+             PyArray_API[82])
+
 #define PyArray_SimpleNew(nd, dims, typenum) \
           PyArray_New(&PyArray_Type, nd, dims, typenum, NULL, NULL, 0, 0, NULL)
 
@@ -565,6 +656,10 @@ inline npy_intp* PyArray_DIMS(PyArrayObject *arr) {
   return ((PyArrayObject_fields *)arr)->dimensions;
 }
 
+inline npy_intp* PyArray_STRIDES(PyArrayObject *arr) {
+  return ((PyArrayObject_fields *)arr)->strides;
+}
+
 inline int PyArray_TYPE(const PyArrayObject *arr) {
   return ((PyArrayObject_fields *)arr)->descr->type_num;
 }
@@ -577,6 +672,28 @@ inline int PyArray_FLAGS(PyArrayObject *arr) {
   return ((PyArrayObject_fields *)arr)->flags;
 }
 
+inline PyArray_Descr* PyArray_DESCR(PyArrayObject *arr) {
+  return ((PyArrayObject_fields *)arr)->descr;
+}
+
+inline int PyArray_ITEMSIZE(PyArrayObject *arr) {
+  return ((PyArrayObject_fields *)arr)->descr->elsize;
+}
+
+// byte order characters used by PyArray_Descr
+#define NPY_LITTLE '<'
+#define NPY_BIG '>'
+#define NPY_NATIVE '='
+#define NPY_IGNORE '|'
+
+inline bool PyArray_ISNBO(char byteorder) {
+  if (byteorder == NPY_NATIVE || byteorder == NPY_IGNORE)
+    return true;
+  const int one = 1;
+  char native = (*(const char*)&one == 1) ? NPY_LITTLE : NPY_BIG;
+  return byteorder == native;
+}
+
 #define PyArray_SIZE(m) PyArray_MultiplyList(PyArray_DIMS(m), PyArray_NDIM(m))
 
 #define PyArray_Check(o) PyObject_TypeCheck(o, &PyArray_Type)
@@ -763,10 +880,24 @@ LIBPYTHON_EXTERN void (*PyEval_SetProfile)(Py_tracefunc func, PyObject *obj);
 LIBPYTHON_EXTERN PyThreadState* (*PyGILState_GetThisThreadState)(void);
 LIBPYTHON_EXTERN PyGILState_STATE (*PyGILState_Ensure)(void);
 LIBPYTHON_EXTERN void (*PyGILState_Release)(PyGILState_STATE);
+
+// optional (Python >= 3.4)
+LIBPYTHON_EXTERN int (*PyGILState_Check)(void);
 LIBPYTHON_EXTERN PyThreadState* (*PyThreadState_Next)(PyThreadState*);
+LIBPYTHON_EXTERN PyThreadState* (*PyEval_SaveThread)(void);
+LIBPYTHON_EXTERN void (*PyEval_RestoreThread)(PyThreadState*);
+LIBPYTHON_EXTERN void (*PyEval_InitThreads)(void);
 
 /* End PyFrameObject */
 
+// might flushing the named sys stream ("stdout" or "stderr") do anything?
+// This is a heuristic, based on the stream's type name: output remapped to
+// R by reticulate, and output captured in a StringIO, is never buffered.
+// Other streams may be (Python has no public way to tell whether a stream
+// holds buffered output), and so are always flushed.
+bool std_buffer_needs_flush(const char* name);
+
+// flush sys.stdout and sys.stderr (those which need it); returns -1 on error
 int flush_std_buffers();
 
 } // namespace libpython
@@ -0,0 +1,146 @@
+//
+// This code implements a queue of tasks to be run on the main thread.
+//
+// Python offers Py_AddPendingCall() for this; however, its table of pending
+// calls is small (32 calls) and is shared with the interpreter itself, and
+// scheduling fails when it's full. Rather than scheduling one pending call
+// per task (and sleeping and retrying whenever the table is full), tasks are
+// pushed onto a queue owned by reticulate, and a single pending call empties
+// the queue in one go. A producer thread only calls Py_AddPendingCall() when
+// no drain of the queue is scheduled yet; if that fails, it waits until some
+// other drain of the queue (including those done by the event loop poller,
+// see event_loop.cpp) has run, rather than sleeping for a fixed interval
+// (or, on the main thread, drains the queue itself).
+//
+
+#include "main_thread.h"
+#include "common.h"
+
+#include "libpython.h"
+using namespace reticulate::libpython;
+
+#include "tinythread.h"
+
+#include <functional>
+#include <map>
+
+bool is_main_thread();
+
+namespace reticulate {
+namespace main_thread {
+
+namespace {
+
+struct Call {
+  Task task;
+  void* data;
+};
+
+// calls are ordered by priority (highest first), and then in the order in
+// which they were scheduled (as std::multimap inserts equal keys last)
+typedef std::multimap<int, Call, std::greater<int> > Queue;
+
+tthread::mutex s_mutex;
+tthread::condition_variable s_drained;
+Queue s_queue;
+
+// is a pending call to drain the queue scheduled?
+bool s_scheduled = false;
+
+int drainPendingCall(void*) {
+  return drain();
+}
+
+// schedule a pending call to drain the queue; the mutex must be held
+bool scheduleDrain() {
+
+  if (s_scheduled)
+    return true;
+
+  // Note that Py_AddPendingCall() is documented to be callable from any
+  // thread, without the GIL.
+  if (Py_AddPendingCall(drainPendingCall, NULL) != 0)
+    return false;
+
+  s_scheduled = true;
+  return true;
+
+}
+
+} // anonymous namespace
+
+void schedule(Task task, void* data, int priority) {
+
+  Call call;
+  call.task = task;
+  call.data = data;
+
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_mutex);
+    s_queue.insert(Queue::value_type(priority, call));
+    if (scheduleDrain())
+      return;
+  }
+
+  // the pending call table is full. Only the main thread drains the queue,
+  // so it can't wait for a drain itself: it runs the queued calls (ours
+  // included) at once instead. As there's no Python code to propagate an
+  // error to, an error raised by a call is printed
+  if (is_main_thread()) {
+    if (drain() != 0)
+      PyErr_Print();
+    return;
+  }
+
+  // other threads wait for a drain to make room (or to run our call),
+  // trying again to schedule a drain whenever one completes. the GIL is
+  // released meanwhile, as the main thread needs it to drain
+  PyThreadState* state = PyEval_SaveThread();
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_mutex);
+    while (!s_queue.empty() && !scheduleDrain())
+      s_drained.wait(s_mutex);
+  }
+  PyEval_RestoreThread(state);
+
+}
+
+int drain() {
+
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_mutex);
+    s_scheduled = false;
+  }
+
+  int status = 0;
+  while (true) {
+
+    Call call;
+    {
+      tthread::lock_guard<tthread::mutex> guard(s_mutex);
+      if (s_queue.empty())
+        break;
+      call = s_queue.begin()->second;
+      s_queue.erase(s_queue.begin());
+    }
+
+    // leave the remaining calls for the next drain, so that the error can
+    // propagate to the Python code the main thread is running
+    if (call.task(call.data) != 0) {
+      status = -1;
+      break;
+    }
+
+  }
+
+  tthread::lock_guard<tthread::mutex> guard(s_mutex);
+  if (!s_queue.empty())
+    scheduleDrain();
+  s_drained.notify_all();
+
+  return status;
+
+}
+
+} // namespace main_thread
+} // namespace reticulate
@@ -0,0 +1,28 @@
+#ifndef RETICULATE_MAIN_THREAD_H
+#define RETICULATE_MAIN_THREAD_H
+
+namespace reticulate {
+namespace main_thread {
+
+// A task to be run on the main thread, with the same signature (and return
+// value conventions) as a callback passed to Py_AddPendingCall(): a task
+// returning -1 must set a Python exception.
+typedef int (*Task)(void*);
+
+// Queue a task to be run on the main thread while it is running Python
+// code. This can be called from any thread holding the GIL (which is
+// released should the caller need to wait for room to schedule the queue's
+// drain; the main thread runs the queued tasks at once instead); tasks with
+// a higher priority are run first, and tasks of equal priority in the order
+// they were scheduled.
+void schedule(Task task, void* data, int priority = 0);
+
+// Run all queued tasks. This must be called on the main thread with the GIL
+// held; it stops at (and returns -1 for) the first task that fails, leaving
+// the remaining tasks queued.
+int drain();
+
+} // namespace main_thread
+} // namespace reticulate
+
+#endif // RETICULATE_MAIN_THREAD_H
@@ -0,0 +1,103 @@
+//
+// This code splits copies of large buffers (e.g. of NumPy arrays into R
+// vectors and back) across threads, so that multi-gigabyte conversions are
+// bound by memory bandwidth rather than by the speed of a single core.
+//
+// Threads are started for each range (and joined before returning), which
+// costs tens of microseconds; ranges are only split when each thread has at
+// least a few megabytes to copy, which takes far longer than that. The
+// calling thread processes the first chunk itself.
+//
+
+#include "parallel.h"
+
+#include "libpython.h"
+using namespace reticulate::libpython;
+
+#include "tinythread.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace reticulate {
+namespace parallel {
+
+namespace {
+
+// the least memory worth handing to a thread of its own
+const double s_chunk_bytes = 4 * 1024 * 1024;
+
+// the default number of threads, when 'reticulate.copy_threads' is unset
+// (copies rarely benefit from more, as they saturate memory bandwidth)
+const int s_default_threads = 8;
+
+struct Task {
+  Worker worker;
+  void* data;
+  R_xlen_t begin;
+  R_xlen_t end;
+};
+
+void run(void* data) {
+  Task* task = (Task*) data;
+  task->worker(task->data, task->begin, task->end);
+}
+
+int thread_count() {
+
+  SEXP value = Rf_GetOption(Rf_install("reticulate.copy_threads"), R_BaseEnv);
+  if (Rf_length(value) == 1 && (TYPEOF(value) == INTSXP || TYPEOF(value) == REALSXP)) {
+    int n = Rf_asInteger(value);
+    return n == NA_INTEGER || n < 1 ? 1 : n;
+  }
+
+  int n = (int) tthread::thread::hardware_concurrency();
+  return std::max(1, std::min(n, s_default_threads));
+
+}
+
+} // end anonymous namespace
+
+void for_range(R_xlen_t n, double bytes, Worker worker, void* data) {
+
+  int count = 1;
+  if (bytes >= 2 * s_chunk_bytes) {
+    count = std::min(thread_count(), (int) std::min(bytes / s_chunk_bytes, 1024.0));
+    count = (int) std::min((R_xlen_t) count, n);
+  }
+
+  if (count <= 1) {
+    worker(data, 0, n);
+    return;
+  }
+
+  R_xlen_t size = (n + count - 1) / count;
+  std::vector<Task> tasks;
+  for (R_xlen_t begin = 0; begin < n; begin += size) {
+    Task task = { worker, data, begin, std::min(begin + size, n) };
+    tasks.push_back(task);
+  }
+
+  PyThreadState* state = PyEval_SaveThread();
+
+  std::vector<tthread::thread*> threads;
+  for (std::size_t i = 1; i < tasks.size(); i++)
+    threads.push_back(new tthread::thread(run, &tasks[i]));
+
+  run(&tasks[0]);
+
+  // chunks whose thread could not be started are run here instead
+  for (std::size_t i = 0; i < threads.size(); i++) {
+    if (threads[i]->joinable())
+      threads[i]->join();
+    else
+      run(&tasks[i + 1]);
+    delete threads[i];
+  }
+
+  PyEval_RestoreThread(state);
+
+}
+
+} // namespace parallel
+} // namespace reticulate
@@ -0,0 +1,26 @@
+#ifndef RETICULATE_PARALLEL_H
+#define RETICULATE_PARALLEL_H
+
+#include <Rinternals.h>
+
+#include <cstddef>
+
+namespace reticulate {
+namespace parallel {
+
+// process the elements [begin, end) of a range; workers are run on
+// threads other than the main thread, and so must not call into R or
+// Python (nor allocate memory from either)
+typedef void (*Worker)(void* data, R_xlen_t begin, R_xlen_t end);
+
+// run 'worker' over the elements [0, n) of a range which touches 'bytes'
+// bytes of memory. ranges large enough to benefit are split into chunks run
+// by a pool of threads ('reticulate.copy_threads' of them at most), with
+// the GIL released while the threads run; smaller ranges are run on the
+// calling thread. must be called from the main thread, with the GIL held
+void for_range(R_xlen_t n, double bytes, Worker worker, void* data);
+
+} // namespace parallel
+} // namespace reticulate
+
+#endif // RETICULATE_PARALLEL_H
@@ -5,6 +5,7 @@
 #define RCPP_NO_SUGAR
 
 #include <Rcpp.h>
+#include <R_ext/Rdynload.h>
 using namespace Rcpp;
 
 #include "signals.h"
@@ -12,10 +13,22 @@ using namespace Rcpp;
 #include "common.h"
 
 #include "event_loop.h"
+#include "main_thread.h"
+#include "altrep.h"
+#include "stats.h"
+#include "parallel.h"
 #include "tinythread.h"
 
+#include <algorithm>
 #include <fstream>
+#include <list>
+#include <map>
+#include <sstream>
 #include <time.h>
+#include <unordered_map>
+#include <cstring>
+#include <cstdlib>
+#include <stdint.h>
 
 #ifndef _WIN32
 #include <dlfcn.h>
@@ -52,10 +65,37 @@ void loadSymbol(void* pLib, const std::string& name, void** ppSymbol)
 }
 
 
-// track whether we have required numpy
-std::string s_numpy_load_error;
+// track whether we have required numpy. NumPy's C API may be imported
+// lazily (see py_initialize()), in which case it's imported the first time
+// it's needed
+enum NumPyState {
+  NUMPY_DEFERRED,
+  NUMPY_LOADED,
+  NUMPY_UNAVAILABLE
+};
+
+NumPyState s_numpy_state = NUMPY_UNAVAILABLE;
+std::string s_numpy_load_error = "Python not initialized";
+
 bool haveNumPy() {
-  return s_numpy_load_error.empty();
+  if (s_numpy_state == NUMPY_DEFERRED) {
+    bool loaded = import_numpy_api(is_python3(), &s_numpy_load_error);
+    if (!loaded)
+      PyErr_Clear();
+    s_numpy_state = loaded ? NUMPY_LOADED : NUMPY_UNAVAILABLE;
+  }
+  return s_numpy_state == NUMPY_LOADED;
+}
+
+// was NumPy imported (by anyone)? no object can be a NumPy array or
+// scalar until it has been, so checking for these needn't import it
+bool numpyImported() {
+  if (s_numpy_state == NUMPY_DEFERRED &&
+      PyDict_GetItemString(PyImport_GetModuleDict(), "numpy") == NULL)
+  {
+    return false;
+  }
+  return haveNumPy();
 }
 
 bool requireNumPy() {
@@ -65,13 +105,13 @@ bool requireNumPy() {
 }
 
 bool isPyArray(PyObject* object) {
-  if (!haveNumPy()) return false;
+  if (!numpyImported()) return false;
 
   return PyArray_Check(object);
 }
 
 bool isPyArrayScalar(PyObject* object) {
-  if (!haveNumPy()) return false;
+  if (!numpyImported()) return false;
 
   return PyArray_CheckScalar(object);
 }
@@ -129,11 +169,101 @@ bool is_main_thread() {
 }
 
 
-int free_sexp(void* sexp) {
-  // wrap Rcpp_precious_remove() to satisfy
-  // Py_AddPendingCall() signature and return value requirements
-  Rcpp_precious_remove((SEXP) sexp);
+// the references queued by python_object_finalize()
+std::vector<PyObject*> s_pending_decrefs;
+
+// how many references may be queued before the finalizer queueing one
+// arranges for them all to be dropped
+const std::size_t s_max_pending_decrefs = 4096;
+
+// has a pending call been scheduled to drop the queued references?
+bool s_pending_decrefs_scheduled = false;
+
+int py_decref_pending_call(void*) {
+
+  // Python runs pending calls on its main thread, which is only R's main
+  // thread (the one queueing references) when R hosts Python
+  if (!is_main_thread())
+    return 0;
+
+  s_pending_decrefs_scheduled = false;
+  py_decref_pending();
+  return 0;
+
+}
+
+void py_decref_later(PyObject* object) {
+
+  s_pending_decrefs.push_back(object);
+  if (s_pending_decrefs.size() < s_max_pending_decrefs)
+    return;
+
+  // drop the queued references at once if this thread holds the GIL, and
+  // otherwise as soon as Python can run a pending call (so as not to wait
+  // for the GIL in the middle of a garbage collection)
+  if (PyGILState_Check != NULL && PyGILState_Check() == 1) {
+    py_decref_pending_impl();
+  } else if (!s_pending_decrefs_scheduled) {
+    if (Py_AddPendingCall(py_decref_pending_call, NULL) == 0)
+      s_pending_decrefs_scheduled = true;
+  }
+
+}
+
+// drop the queued references when R exits, as the side effects of the
+// objects' finalizers (e.g. flushing files) would otherwise be lost
+void py_decref_pending_at_exit(SEXP) {
+  py_decref_pending();
+}
+
+void py_decref_pending_register_exit_hook() {
+  SEXP hook = PROTECT(R_MakeExternalPtr(NULL, R_NilValue, R_NilValue));
+  R_PreserveObject(hook);
+  R_RegisterCFinalizerEx(hook, py_decref_pending_at_exit, TRUE);
+  UNPROTECT(1);
+}
+
+void py_decref_pending_impl() {
+
+  if (!s_is_python_initialized)
+    return;
+
+  GILScope scope;
+
+  // dropping a reference can run arbitrary code (which may itself call
+  // back into R, and trigger further finalizers), so take the queue first
+  std::vector<PyObject*> pending;
+  pending.swap(s_pending_decrefs);
+  for (std::size_t i = 0; i < pending.size(); i++)
+    Py_DecRef(pending[i]);
+
+  // reuse the queue's storage, unless more references were queued meanwhile
+  if (s_pending_decrefs.empty()) {
+    pending.clear();
+    pending.swap(s_pending_decrefs);
+  }
+
+}
+
+// R objects released by Python from threads other than the main thread are
+// likewise queued, and removed from the precious list in one batch by a
+// single task scheduled on the main thread
+tthread::mutex s_pending_releases_mutex;
+std::vector<SEXP> s_pending_releases;
+
+int free_pending_sexps(void*) {
+
+  std::vector<SEXP> pending;
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_pending_releases_mutex);
+    pending.swap(s_pending_releases);
+  }
+
+  for (std::size_t i = 0; i < pending.size(); i++)
+    Rcpp_precious_remove(pending[i]);
+
   return 0;
+
 }
 
 void Rcpp_precious_remove_main_thread(SEXP object) {
@@ -141,23 +271,17 @@ void Rcpp_precious_remove_main_thread(SEXP object) {
     return Rcpp_precious_remove(object);
   }
 
-  // #Py_AddPendingCall can fail sometimes, so we retry a few times
-  const size_t wait_ms = 100;
-  size_t waited_ms = 0;
-  while (Py_AddPendingCall(free_sexp, object) != 0) {
-
-    tthread::this_thread::sleep_for(tthread::chrono::milliseconds(wait_ms));
-
-    // increment total wait time and print a warning every 60 seconds
-    waited_ms += wait_ms;
-    if ((waited_ms % 60000) == 0)
-        PySys_WriteStderr("Waiting to schedule object finalizer on main R interpeter thread...\n");
-    else if (waited_ms > 60000 * 2) {
-        // if we've waited more than 2 minutes, something is wrong
-        PySys_WriteStderr("Error: unable to register R object finalizer on main thread\n");
-        return;
-    }
+  // schedule a task with the first object queued; the task frees all the
+  // objects queued by the time it runs
+  bool schedule;
+  {
+    tthread::lock_guard<tthread::mutex> guard(s_pending_releases_mutex);
+    schedule = s_pending_releases.empty();
+    s_pending_releases.push_back(object);
   }
+
+  if (schedule)
+    reticulate::main_thread::schedule(free_pending_sexps, NULL);
 }
 
 void py_capsule_free(PyObject* capsule) {
@@ -263,8 +387,107 @@ inline PyObject* PyUnicode_AsBytes(PyObject* str) {
 
 PyObject* as_python_str(const std::string& str);
 
+// the minor version of Python 3 (e.g. 11 for Python 3.11)
+int python3_minor_version() {
+  static int minor = -1;
+  if (minor == -1) {
+    const char* dot = std::strchr(Py_GetVersion(), '.');
+    minor = dot == NULL ? 0 : std::atoi(dot + 1);
+  }
+  return minor;
+}
+
+// the characters of a Python 3 string held in one byte each (i.e. ASCII or
+// Latin-1), read from the string's own (PEP 393) data, or NULL for strings
+// using wider characters, and for those whose data isn't ready yet
+const unsigned char* py_str_1byte_data(PyObject* str, bool* ascii) {
+
+  int minor = python3_minor_version();
+  if (minor < 3)
+    return NULL;
+
+  PyASCIIObject_fields* fields = (PyASCIIObject_fields*) str;
+  if (fields->state.kind != PyUnicode_1BYTE_KIND)
+    return NULL;
+  if (minor < 12 && !fields->state.ready)
+    return NULL;
+
+  // compact strings are followed by their data, which follows the UTF-8
+  // cache (and, before Python 3.12, the wchar_t representation) of
+  // non-ASCII strings; other strings point to their data
+  std::size_t offset = sizeof(PyASCIIObject_fields) + (minor < 12 ? sizeof(void*) : 0);
+  if (!fields->state.ascii || !fields->state.compact)
+    offset += sizeof(Py_ssize_t) + sizeof(char*) + (minor < 12 ? sizeof(Py_ssize_t) : 0);
+
+  *ascii = fields->state.ascii;
+  const char* base = (const char*) str + offset;
+  if (fields->state.compact)
+    return (const unsigned char*) base;
+
+  void* data;
+  std::memcpy(&data, base, sizeof(void*));
+  return (const unsigned char*) data;
+
+}
+
+// the UTF-8 representation of a Python 3 string. ASCII strings are their
+// own UTF-8, and Latin-1 strings are encoded into `buffer`; for others,
+// Python computes a UTF-8 copy once and caches it with the string. (Those
+// copies are avoided where possible, as they're kept for as long as the
+// string lives.) Returns NULL if the string can't be encoded (e.g. because
+// it contains lone surrogates)
+const char* py_str_utf8(PyObject* str, Py_ssize_t* size, std::string& buffer) {
+
+  if (!is_python3() || !PyUnicode_Check(str))
+    return NULL;
+
+  bool ascii;
+  const unsigned char* chars = py_str_1byte_data(str, &ascii);
+  if (chars != NULL) {
+
+    Py_ssize_t length = ((PyASCIIObject_fields*) str)->length;
+    if (ascii) {
+      *size = length;
+      return (const char*) chars;
+    }
+
+    buffer.clear();
+    buffer.reserve(2 * length);
+    for (Py_ssize_t i = 0; i < length; i++) {
+      unsigned char c = chars[i];
+      if (c < 0x80) {
+        buffer.push_back(c);
+      } else {
+        buffer.push_back(0xC0 | (c >> 6));
+        buffer.push_back(0x80 | (c & 0x3F));
+      }
+    }
+
+    *size = buffer.size();
+    return buffer.data();
+
+  }
+
+  const char* data = PyUnicode_AsUTF8AndSize(str, size);
+  if (data == NULL) {
+    PyErr_Clear();
+    return NULL;
+  }
+
+  return data;
+
+}
+
 std::string as_std_string(PyObject* str) {
 
+  Py_ssize_t size;
+  std::string utf8;
+  const char* data = py_str_utf8(str, &size, utf8);
+  if (data == utf8.data())
+    return utf8;
+  else if (data != NULL)
+    return std::string(data, size);
+
   // conver to bytes if its unicode
   PyObjectPtr pStr;
   if (PyUnicode_Check(str) || isPyArrayScalar(str)) {
@@ -283,7 +506,129 @@ std::string as_std_string(PyObject* str) {
   return std::string(buffer, length);
 }
 
-#define as_utf8_r_string(str) Rcpp::String(as_std_string(str))
+// the CHARSXP for a Python string, in UTF-8
+SEXP as_utf8_charsxp(PyObject* str) {
+
+  Py_ssize_t size;
+  std::string utf8;
+  const char* data = py_str_utf8(str, &size, utf8);
+  if (data != NULL) {
+    // R strings can't contain embedded nuls, so (as for the conversion
+    // through a C string below) truncate at the first one
+    const void* nul = std::memchr(data, 0, size);
+    if (nul != NULL)
+      size = (const char*) nul - data;
+    return Rf_mkCharLenCE(data, size, CE_UTF8);
+  }
+
+  return Rf_mkCharCE(as_std_string(str).c_str(), CE_UTF8);
+
+}
+
+#define as_utf8_r_string(str) Rcpp::String(as_utf8_charsxp(str))
+
+// a new reference to the Python string for an R string
+PyObject* py_str_new(SEXP charsxp) {
+  // UTF-8 strings are decoded directly from R's memory
+  return Rf_getCharCE(charsxp) == CE_UTF8 ?
+    PyUnicode_FromStringAndSize(CHAR(charsxp), LENGTH(charsxp)) :
+    PyUnicode_FromString(Rf_translateCharUTF8(charsxp));
+}
+
+// Small caches of the names (list names, dict keys, column and keyword
+// names) most recently converted between R and Python, so that repeated
+// names are converted once rather than once per occurrence. R's CHARSXPs and
+// Python's strings are both immutable, so entries are keyed by object
+// identity; each cache is direct-mapped and holds on to its keys (the
+// CHARSXPs in a preserved character vector), so a key's address can't be
+// reused while it is cached. Other strings aren't cached, nor are names
+// longer than s_max_length bytes, so the caches stay small.
+namespace intern {
+
+const std::size_t s_size = 1024;  // must be a power of 2
+const int s_max_length = 64;
+
+struct RToPyEntry {
+  SEXP key;
+  PyObject* value;
+};
+
+struct PyToREntry {
+  PyObject* key;
+  SEXP value;
+};
+
+RToPyEntry s_r_to_py[s_size];
+PyToREntry s_py_to_r[s_size];
+
+// the CHARSXPs referenced by both caches
+SEXP s_charsxps = NULL;
+
+SEXP charsxps() {
+  if (s_charsxps == NULL) {
+    s_charsxps = Rf_allocVector(STRSXP, 2 * s_size);
+    R_PreserveObject(s_charsxps);
+  }
+  return s_charsxps;
+}
+
+inline std::size_t slot(const void* object) {
+  // objects are (at least) 8 byte aligned, so drop the low bits
+  std::size_t hash = (std::size_t) ((uintptr_t) object >> 3) * 2654435761u;
+  return (hash >> 7) & (s_size - 1);
+}
+
+// a new reference to the Python string for an R string
+PyObject* py_str(SEXP charsxp) {
+
+  if (LENGTH(charsxp) > s_max_length)
+    return py_str_new(charsxp);
+
+  RToPyEntry& entry = s_r_to_py[slot(charsxp)];
+  if (entry.key == charsxp) {
+    Py_IncRef(entry.value);
+    return entry.value;
+  }
+
+  PyObject* value = py_str_new(charsxp);
+  if (value == NULL)
+    return NULL;
+
+  SET_STRING_ELT(charsxps(), slot(charsxp), charsxp);
+  if (entry.value != NULL)
+    Py_DecRef(entry.value);
+  Py_IncRef(value);
+  entry.key = charsxp;
+  entry.value = value;
+
+  return value;
+
+}
+
+// the (UTF-8) R string for a Python string
+SEXP r_str(PyObject* str) {
+
+  PyToREntry& entry = s_py_to_r[slot(str)];
+  if (entry.key == str)
+    return entry.value;
+
+  SEXP cached = charsxps();
+  SEXP charsxp = as_utf8_charsxp(str);
+  if (LENGTH(charsxp) > s_max_length)
+    return charsxp;
+
+  SET_STRING_ELT(cached, s_size + slot(str), charsxp);
+  Py_IncRef(str);
+  if (entry.key != NULL)
+    Py_DecRef(entry.key);
+  entry.key = str;
+  entry.value = charsxp;
+
+  return charsxp;
+
+}
+
+} // namespace intern
 
 PyObject* as_python_str(SEXP strSEXP, bool handle_na=false) {
   if (handle_na && strSEXP == NA_STRING) {
@@ -294,14 +639,21 @@ PyObject* as_python_str(SEXP strSEXP, bool handle_na=false) {
   if (is_python3()) {
     // python3 doesn't have PyString and all strings are unicode so
     // make sure we get a unicode representation from R
-    const char * value = Rf_translateCharUTF8(strSEXP);
-    return PyUnicode_FromString(value);
+    return py_str_new(strSEXP);
   } else {
     const char * value = Rf_translateChar(strSEXP);
     return PyString_FromString(value);
   }
 }
 
+// the Python string for an R string used as a name (e.g. a dict key)
+PyObject* as_python_name(SEXP strSEXP) {
+  if (is_python3())
+    return intern::py_str(strSEXP);
+  else
+    return as_python_str(strSEXP);
+}
+
 PyObject* as_python_str(const std::string& str) {
   if (is_python3()) {
     return PyUnicode_FromString(str.c_str());
@@ -408,6 +760,24 @@ bool is_python_str(PyObject* x) {
     return false;
 }
 
+// the R string for a Python object used as a name (e.g. a dict key),
+// converting it with str() if it isn't a string itself
+SEXP as_r_name(PyObject* object) {
+
+  if (PyUnicode_Check(object))
+    return intern::r_str(object);
+
+  if (is_python_str(object))
+    return as_utf8_charsxp(object);
+
+  PyObjectPtr str(PyObject_Str(object));
+  if (str.is_null())
+    throw PythonException(py_fetch_error());
+
+  return as_utf8_charsxp(str);
+
+}
+
 // check whether a PyObject is None
 bool py_is_none(PyObject* object) {
   return object == Py_None;
@@ -445,6 +815,8 @@ std::string as_r_class(PyObject* classPtr) {
 
 std::vector<std::string> py_class_names(PyObject* object) {
 
+  RETICULATE_STATS_TIME(CLASS_LOOKUP);
+
   // class
   PyObjectPtr classPtr(PyObject_GetAttrString(object, "__class__"));
   if (classPtr.is_null())
@@ -482,15 +854,159 @@ std::vector<std::string> py_class_names(PyObject* object) {
 
 }
 
+// Cache of the (filtered) R class vectors computed for Python types, so that
+// we needn't call inspect.getmro() and the R-level class filters for every
+// object we wrap. Entries are validated against the type's version tag,
+// which Python changes whenever the type (or one of its bases) is modified,
+// and the cache is discarded whenever the class filters change.
+struct PyClassCacheEntry {
+  unsigned int version;
+  SEXP classes;
+};
+
+typedef std::unordered_map<PyObject*, PyClassCacheEntry> PyClassCache;
+PyClassCache s_class_cache;
+
+// types are rarely created dynamically in large numbers, but we don't
+// want the cache to grow without bound if they are
+const std::size_t s_class_cache_max_size = 4096;
+
+// returns 0 if the type has no valid version tag
+unsigned int py_type_version_tag(PyObject* type) {
+  if (!PyType_Check(type))
+    return 0;
+  if (!PyType_HasFeature((PyTypeObject*) type, Py_TPFLAGS_VALID_VERSION_TAG))
+    return 0;
+  return ((PyTypeObject_fields*) type)->tp_version_tag;
+}
+
+// Cache of module attribute lookups (e.g. for `np$linalg`), so that
+// repeatedly accessing a module member from R needn't look it up through the
+// module's type, nor compute the classes of its reference again. Entries hold
+// no references to the module or the member: they are validated by looking
+// the (pre-hashed) name up in the module's dict, and checking the types of
+// the module and of the object found there against those (and their version
+// tags) seen when the entry was made. Each hit returns a new reference to
+// the object, so that changes made to one reference from R (e.g. by
+// py_set_convert()) don't leak into the others.
+struct PyAttrCacheEntry {
+  PyObject* name;
+  PyObject* moduleType;
+  unsigned int moduleVersion;
+  PyObject* type;
+  unsigned int version;
+  R_xlen_t classes;  // index of the classes in s_attr_cache_classes
+};
+
+typedef std::unordered_map<std::string, PyAttrCacheEntry> PyAttrCacheModule;
+typedef std::unordered_map<PyObject*, PyAttrCacheModule> PyAttrCache;
+PyAttrCache s_attr_cache;
+std::size_t s_attr_cache_size = 0;
+
+const std::size_t s_attr_cache_max_size = 4096;
+
+// the classes of the cached references, held in a single preserved list
+SEXP s_attr_cache_classes = R_NilValue;
+
+void py_clear_attr_cache() {
+
+  for (PyAttrCache::iterator it = s_attr_cache.begin();
+       it != s_attr_cache.end();
+       ++it)
+  {
+    PyAttrCacheModule& entries = it->second;
+    for (PyAttrCacheModule::iterator entry = entries.begin();
+         entry != entries.end();
+         ++entry)
+    {
+      Py_DecRef(entry->second.name);
+    }
+  }
+
+  s_attr_cache.clear();
+  s_attr_cache_size = 0;
+
+  if (s_attr_cache_classes != R_NilValue) {
+    R_ReleaseObject(s_attr_cache_classes);
+    s_attr_cache_classes = R_NilValue;
+  }
+
+}
+
+// [[Rcpp::export]]
+void py_clear_class_cache() {
+  for (PyClassCache::iterator it = s_class_cache.begin();
+       it != s_class_cache.end();
+       ++it)
+  {
+    R_ReleaseObject(it->second.classes);
+  }
+  s_class_cache.clear();
+
+  // cached attribute references carry the classes computed for them
+  py_clear_attr_cache();
+}
+
+SEXP py_class_cache_get(PyObject* type) {
+
+  PyClassCache::iterator it = s_class_cache.find(type);
+  if (it == s_class_cache.end())
+    return R_NilValue;
+
+  unsigned int version = py_type_version_tag(type);
+  if (version == 0 || version != it->second.version) {
+    R_ReleaseObject(it->second.classes);
+    s_class_cache.erase(it);
+    return R_NilValue;
+  }
+
+  return it->second.classes;
+
+}
+
+void py_class_cache_put(PyObject* type, SEXP classes) {
+
+  unsigned int version = py_type_version_tag(type);
+  if (version == 0)
+    return;
+
+  if (s_class_cache.size() >= s_class_cache_max_size)
+    py_clear_class_cache();
+
+  // the vector is shared by all instances of the type
+  MARK_NOT_MUTABLE(classes);
+  R_PreserveObject(classes);
+
+  PyClassCacheEntry entry = { version, classes };
+  s_class_cache[type] = entry;
+
+}
+
 // wrap a PyObject
 PyObjectRef py_ref(PyObject* object,
                    bool convert,
                    const std::string& extraClass = "")
 {
+  RETICULATE_STATS_COUNT(PY_REF);
 
   // wrap
   PyObjectRef ref(object, convert);
 
+  // use the cached classes for this type when available
+  PyObjectPtr classPtr;
+  if (extraClass.empty()) {
+    classPtr.assign(PyObject_GetAttrString(object, "__class__"));
+    if (classPtr.is_null()) {
+      PyErr_Clear();
+    } else {
+      SEXP classes = py_class_cache_get(classPtr);
+      if (classes != R_NilValue) {
+        ref.attr("class") = classes;
+        return ref;
+      }
+    }
+  }
+
   // class attribute
   std::vector<std::string> attrClass;
 
@@ -516,10 +1032,12 @@ PyObjectRef py_ref(PyObject* object,
   // apply class filter
   Rcpp::Environment pkgEnv = Rcpp::Environment::namespace_env("reticulate");
   Rcpp::Function py_filter_classes = pkgEnv["py_filter_classes"];
-  attrClass = as< std::vector<std::string> >(py_filter_classes(attrClass));
+  CharacterVector classes = py_filter_classes(attrClass);
 
   // set classes
-  ref.attr("class") = attrClass;
+  ref.attr("class") = classes;
+  if (!classPtr.is_null())
+    py_class_cache_put(classPtr, classes);
 
   // return ref
   return ref;
@@ -558,6 +1076,16 @@ void py_validate_xptr(PyObjectRef x) {
   }
 }
 
+// [[Rcpp::export]]
+bool py_get_convert(PyObjectRef x) {
+  return x.convert();
+}
+
+// [[Rcpp::export]]
+void py_set_convert(PyObjectRef x, bool convert) {
+  x.set_convert(convert);
+}
+
 
 bool option_is_true(const std::string& name) {
   SEXP valueSEXP = Rf_GetOption(Rf_install(name.c_str()), R_BaseEnv);
@@ -607,29 +1135,6 @@ SEXP current_env(void) {
   return Rf_eval(call, R_BaseEnv);
 }
 
-SEXP get_current_call(void) {
-  static SEXP call = NULL;
-
-  if (!call) {
-    ParseStatus status;
-    SEXP code = PROTECT(Rf_mkString("sys.call(-1)"));
-    SEXP parsed = PROTECT(R_ParseVector(code, -1, &status, R_NilValue));
-    SEXP body = VECTOR_ELT(parsed, 0);
-
-    SEXP fn = PROTECT(Rf_allocSExp(CLOSXP));
-    SET_FORMALS(fn, R_NilValue);
-    SET_BODY(fn, body);
-    SET_CLOENV(fn, R_BaseEnv);
-
-    call = Rf_lang1(fn);
-    R_PreserveObject(call);
-
-    UNPROTECT(3);
-  }
-
-  return Rf_eval(call, R_BaseEnv);
-}
-
 SEXP get_r_trace(bool maybe_use_cached = false) {
   static SEXP get_r_trace_s = NULL;
   static SEXP reticulate_ns = NULL;
@@ -649,6 +1154,8 @@ SEXP get_r_trace(bool maybe_use_cached = false) {
 
 SEXP py_fetch_error(bool maybe_reuse_cached_r_trace) {
 
+  RETICULATE_STATS_TIME(PY_FETCH_ERROR);
+
   // TODO: we need to add a guardrail to catch cases when
   // this is being invoked from not the main thread
 
@@ -681,7 +1188,8 @@ SEXP py_fetch_error(bool maybe_reuse_cached_r_trace) {
 
   PyObjectPtr pExcType(excType);  // decref on exit
 
-  if (!PyObject_HasAttrString(excValue, "call")) {
+  if (!PyObject_HasAttrString(excValue, "call") &&
+      !PyObject_HasAttrString(excValue, "trace")) {
     // check if this exception originated in python using the `raise from`
     // statement with an exception that we've already augmented with the full
     // r_trace. (or similarly, raised a new exception inside an `except:` block
@@ -710,7 +1218,10 @@ SEXP py_fetch_error(bool maybe_reuse_cached_r_trace) {
 
 
 
-  // make sure the exception object has some some attrs: call, trace
+  // make sure the exception object has a trace. this is only a cheap
+  // snapshot of the R call stack (see get_r_trace()); the rlang trace, and
+  // the call (the last call on the stack), are built from it when they're
+  // accessed
   if (!PyObject_HasAttrString(excValue, "trace")) {
     SEXP r_trace = PROTECT(get_r_trace(maybe_reuse_cached_r_trace));
     PyObject* r_trace_capsule(py_capsule_new(r_trace));
@@ -719,22 +1230,6 @@ SEXP py_fetch_error(bool maybe_reuse_cached_r_trace) {
     UNPROTECT(1);
   }
 
-  // Otherwise, try to capture the current call.
-
-  // A first draft of this tried using: SEXP r_call = get_last_call();
-  // with get_last_call() defined in Rcpp headers. Unfortunately, that would
-  // skip over the actual call of interest, and frequently return NULL
-  // for shallow call stacks. So we fetch the call directly
-  // using the R API.
-  if (!PyObject_HasAttrString(excValue, "call")) {
-    SEXP r_call = get_current_call();
-    PyObject *r_call_capsule(py_capsule_new(r_call));
-    PyObject_SetAttrString(excValue, "call", r_call_capsule);
-    Py_DecRef(r_call_capsule);
-    UNPROTECT(1);
-  }
-
-
   // get the cppstack, r_cppstack
   // FIXME: this doesn't seem to work, always returns NULL
   // SEXP r_cppstack = PROTECT(rcpp_get_stack_trace());
@@ -934,15 +1429,27 @@ bool is_pandas_na_like(PyObject* x) {
   return is_pandas_na(x) || (x == Py_None) || (x == (PyObject*)np_nan);
 }
 
-void set_string_element(SEXP rArray, int i, PyObject* pyStr) {
-  if (is_pandas_na_like(pyStr)) {
-    SET_STRING_ELT(rArray, i, NA_STRING);
-    return;
-  }
+SEXP as_r_charsxp(PyObject* pyStr) {
+  if (is_pandas_na_like(pyStr))
+    return NA_STRING;
+  if (PyUnicode_Check(pyStr))
+    return as_utf8_charsxp(pyStr);
   std::string str = as_std_string(pyStr);
-  cetype_t ce = PyUnicode_Check(pyStr) ? CE_UTF8 : CE_NATIVE;
-  SEXP strSEXP = Rf_mkCharCE(str.c_str(), ce);
-  SET_STRING_ELT(rArray, i, strSEXP);
+  return Rf_mkCharCE(str.c_str(), CE_NATIVE);
+}
+
+void set_string_element(SEXP rArray, R_xlen_t i, PyObject* pyStr) {
+  SET_STRING_ELT(rArray, i, as_r_charsxp(pyStr));
+}
+
+// check whether the elements of an object array are all strings (or NA)
+bool is_string_object_array(PyObject** pData, npy_intp len) {
+  for (npy_intp i = 0; i < len; i++) {
+    PyObject* el = pData[i];
+    if (!is_python_str(el) && !is_pandas_na_like(el))
+      return false;
+  }
+  return true;
 }
 
 bool py_is_callable(PyObject* x) {
@@ -973,49 +1480,977 @@ PyObject* get_np_nditer () {
   return np_nditer;
 }
 
-// convert a python object to an R object
-SEXP py_to_r(PyObject* x, bool convert) {
-
-  // NULL for Python None
-  if (py_is_none(x))
-    return R_NilValue;
-
-  // check for scalars
-  int scalarType = r_scalar_type(x);
-  if (scalarType != NILSXP) {
+// the R vector type used to hold a numpy array of (narrowed) type typenum,
+// or NILSXP for arrays which need to be converted element by element
+SEXPTYPE numpy_r_type(int typenum) {
+  switch (typenum) {
+  case NPY_BOOL:    return LGLSXP;
+  case NPY_LONG:    return INTSXP;
+  case NPY_DOUBLE:  return REALSXP;
+  case NPY_CDOUBLE: return CPLXSXP;
+  default:          return NILSXP;
+  }
+}
 
-    // logical
-    if (scalarType == LGLSXP)
-      return LogicalVector::create(x == Py_True);
+template <typename S, typename D>
+void numpy_copy_elements(const void* src, void* dst, npy_intp n) {
+  const S* pSrc = (const S*) src;
+  D* pDst = (D*) dst;
+  for (npy_intp i = 0; i < n; i++)
+    pDst[i] = (D) pSrc[i];
+}
 
-    // integer
-    else if (scalarType == INTSXP)
-      return IntegerVector::create(PyInt_AsLong(x));
+void numpy_copy_complex64(const void* src, void* dst, npy_intp n) {
+  const npy_complex64* pSrc = (const npy_complex64*) src;
+  Rcomplex* pDst = (Rcomplex*) dst;
+  for (npy_intp i = 0; i < n; i++) {
+    pDst[i].r = pSrc[i].real;
+    pDst[i].i = pSrc[i].imag;
+  }
+}
 
-    // double
-    else if (scalarType == REALSXP)
-      return NumericVector::create(PyFloat_AsDouble(x));
+// the "dim" attribute of the R array holding a numpy array, treating 0-dim
+// arrays (numpy scalars) as 1-dim arrays; this is NULL for 1-dim arrays too
+// long to have an (integer) extent, which are converted to long vectors
+SEXP numpy_r_dims(PyArrayObject* array) {
 
-    // complex
-    else if (scalarType == CPLXSXP) {
-      Rcomplex cplx;
-      cplx.r = PyComplex_RealAsDouble(x);
-      cplx.i = PyComplex_ImagAsDouble(x);
-      return ComplexVector::create(cplx);
-    }
+  int nd = PyArray_NDIM(array);
+  if (nd == 0)
+    return IntegerVector::create(1);
 
-    // string
-    else if (scalarType == STRSXP)
-      return CharacterVector::create(as_utf8_r_string(x));
+  npy_intp* dims = PyArray_DIMS(array);
+  if (nd == 1 && dims[0] > INT_MAX)
+    return R_NilValue;
 
-    else
-      return R_NilValue; // keep compiler happy
+  IntegerVector dimsVector(nd);
+  for (int i = 0; i < nd; i++) {
+    if (dims[i] > INT_MAX)
+      stop("array dimension %i (of extent %.0f) is too large for an R array",
+           i + 1, (double) dims[i]);
+    dimsVector[i] = dims[i];
   }
+  return dimsVector;
 
-  // list
-  else if (PyList_CheckExact(x)) {
+}
 
-    Py_ssize_t len = PyList_Size(x);
+// allocate an R vector of length len, with the "dim" attribute dims
+// (as returned by numpy_r_dims())
+SEXP numpy_r_alloc(SEXPTYPE type, npy_intp len, SEXP dims) {
+  RObject result(Rf_allocVector(type, len));
+  if (dims != R_NilValue)
+    result.attr("dim") = dims;
+  return result;
+}
+
+typedef void (*numpy_copy_fn)(const void*, void*, npy_intp);
+
+// select a kernel copying the elements of a contiguous array of type
+// typenum into an R vector of type rtype (NULL if there isn't one)
+numpy_copy_fn numpy_copy_kernel(int typenum, SEXPTYPE rtype) {
+
+  switch (rtype) {
+
+  case LGLSXP:
+    switch (typenum) {
+    case NPY_BOOL:      return numpy_copy_elements<npy_bool, int>;
+    }
+    break;
+
+  case INTSXP:
+    switch (typenum) {
+    case NPY_BYTE:      return numpy_copy_elements<signed char, int>;
+    case NPY_UBYTE:     return numpy_copy_elements<unsigned char, int>;
+    case NPY_SHORT:     return numpy_copy_elements<short, int>;
+    case NPY_USHORT:    return numpy_copy_elements<unsigned short, int>;
+    case NPY_INT:       return numpy_copy_elements<int, int>;
+    }
+    break;
+
+  case REALSXP:
+    switch (typenum) {
+    case NPY_UINT:      return numpy_copy_elements<unsigned int, double>;
+    case NPY_LONG:      return numpy_copy_elements<long, double>;
+    case NPY_ULONG:     return numpy_copy_elements<unsigned long, double>;
+    case NPY_LONGLONG:  return numpy_copy_elements<long long, double>;
+    case NPY_ULONGLONG: return numpy_copy_elements<unsigned long long, double>;
+    case NPY_FLOAT:     return numpy_copy_elements<float, double>;
+    case NPY_DOUBLE:    return numpy_copy_elements<double, double>;
+    }
+    break;
+
+  case CPLXSXP:
+    switch (typenum) {
+    case NPY_CFLOAT:    return numpy_copy_complex64;
+    case NPY_CDOUBLE:   return numpy_copy_elements<Rcomplex, Rcomplex>;
+    }
+    break;
+
+  }
+
+  return NULL;
+
+}
+
+// a kernel copying a contiguous block of elements, run in chunks by
+// reticulate::parallel::for_range()
+struct NumpyCopyRange {
+  numpy_copy_fn kernel;
+  const char* src;
+  char* dst;
+  std::size_t srcsize;
+  std::size_t dstsize;
+};
+
+void numpy_copy_range(void* data, R_xlen_t begin, R_xlen_t end) {
+  NumpyCopyRange* range = (NumpyCopyRange*) data;
+  range->kernel(range->src + begin * range->srcsize,
+                range->dst + begin * range->dstsize,
+                end - begin);
+}
+
+// copy a block of bytes, run in chunks by for_range()
+struct MemcpyRange {
+  const char* src;
+  char* dst;
+};
+
+void memcpy_range(void* data, R_xlen_t begin, R_xlen_t end) {
+  MemcpyRange* range = (MemcpyRange*) data;
+  std::memcpy(range->dst + begin, range->src + begin, end - begin);
+}
+
+void parallel_memcpy(void* dst, const void* src, R_xlen_t bytes) {
+  MemcpyRange range = { (const char*) src, (char*) dst };
+  reticulate::parallel::for_range(bytes, 2.0 * bytes, memcpy_range, &range);
+}
+
+std::size_t r_element_size(SEXPTYPE rtype) {
+  switch (rtype) {
+  case LGLSXP:
+  case INTSXP:  return sizeof(int);
+  case REALSXP: return sizeof(double);
+  case CPLXSXP: return sizeof(Rcomplex);
+  case RAWSXP:  return sizeof(Rbyte);
+  default:      return 0;
+  }
+}
+
+// copy (and convert) the contents of a numeric numpy array into an
+// R vector of the same length, in Fortran order
+void numpy_copy_into(PyArrayObject* array, SEXP rArray) {
+
+  npy_intp len = PyArray_SIZE(array);
+  if (len == 0)
+    return;
+
+  SEXPTYPE rtype = TYPEOF(rArray);
+
+  // arrays with R's memory layout can be copied in a single pass,
+  // without asking numpy for an intermediate casted copy
+  int required = NPY_ARRAY_F_CONTIGUOUS | NPY_ARRAY_ALIGNED;
+  PyArray_Descr* descr = PyArray_DESCR(array);
+  if ((PyArray_FLAGS(array) & required) == required &&
+      PyArray_ISNBO(descr->byteorder))
+  {
+    numpy_copy_fn kernel = numpy_copy_kernel(descr->type_num, rtype);
+    if (kernel != NULL) {
+      NumpyCopyRange range = {
+        kernel, (const char*) PyArray_DATA(array), (char*) DATAPTR(rArray),
+        (std::size_t) PyArray_ITEMSIZE(array), r_element_size(rtype)
+      };
+      double bytes = (double) len * (range.srcsize + range.dstsize);
+      reticulate::parallel::for_range(len, bytes, numpy_copy_range, &range);
+      RETICULATE_STATS_COPY(len, len * PyArray_ITEMSIZE(array));
+      return;
+    }
+  }
+
+  // otherwise, wrap the R vector's memory in a Fortran-ordered numpy array
+  // and let numpy cast and copy into it directly
+  int typenum;
+  switch (rtype) {
+  case LGLSXP:
+  case INTSXP:  typenum = NPY_INT; break;
+  case REALSXP: typenum = NPY_DOUBLE; break;
+  case CPLXSXP: typenum = NPY_CDOUBLE; break;
+  default: stop("internal error: unexpected R type in numpy_copy_into");
+  }
+
+  PyObjectPtr target(PyArray_New(
+    &PyArray_Type, PyArray_NDIM(array), PyArray_DIMS(array), typenum,
+    NULL, DATAPTR(rArray), 0, NPY_ARRAY_FARRAY, NULL));
+  if (target.is_null())
+    throw PythonException(py_fetch_error());
+
+  if (PyArray_CopyInto((PyArrayObject*) target.get(), array) != 0)
+    throw PythonException(py_fetch_error());
+
+  RETICULATE_STATS_COPY(len, len * PyArray_ITEMSIZE(array));
+
+}
+
+// a strided block of host memory exported by a Python object through the
+// buffer protocol, the array interface, or DLPack
+struct HostArray {
+  char* data;
+  char kind;      // 'b' (bool), 'i' (signed), 'u' (unsigned), 'f', or 'c'
+  int itemsize;
+  bool swap;      // stored in non-native byte order?
+  bool bytes;     // plain bytes, converted to a raw vector
+  std::vector<Py_ssize_t> shape;
+  std::vector<Py_ssize_t> strides;  // in bytes
+};
+
+bool host_array_valid_kind(char kind, int itemsize) {
+  switch (kind) {
+  case 'b': return itemsize == 1;
+  case 'i':
+  case 'u': return itemsize == 1 || itemsize == 2 || itemsize == 4 || itemsize == 8;
+  case 'f': return itemsize == 4 || itemsize == 8;
+  case 'c': return itemsize == 8 || itemsize == 16;
+  default:  return false;
+  }
+}
+
+bool host_little_endian() {
+  int one = 1;
+  return *((char*) &one) == 1;
+}
+
+// parse an array interface type string, e.g. '<f8' or '|b1'
+bool host_array_parse_typestr(const std::string& typestr, HostArray* pArray) {
+
+  if (typestr.size() < 3)
+    return false;
+
+  char order = typestr[0];
+  if (order == '<')
+    pArray->swap = !host_little_endian();
+  else if (order == '>')
+    pArray->swap = host_little_endian();
+  else if (order == '|' || order == '=')
+    pArray->swap = false;
+  else
+    return false;
+
+  pArray->kind = typestr[1];
+  pArray->itemsize = std::atoi(typestr.c_str() + 2);
+  pArray->bytes = false;
+  return host_array_valid_kind(pArray->kind, pArray->itemsize);
+
+}
+
+// parse a (single element) struct module format string, as used by the
+// buffer protocol
+bool host_array_parse_format(const char* format, Py_ssize_t itemsize, HostArray* pArray) {
+
+  // a NULL format implies unsigned bytes
+  std::string fmt = format == NULL ? "B" : format;
+
+  pArray->swap = false;
+  if (!fmt.empty()) {
+    char order = fmt[0];
+    if (order == '<' || order == '>' || order == '!' || order == '=' || order == '@') {
+      if (order == '<')
+        pArray->swap = !host_little_endian();
+      else if (order == '>' || order == '!')
+        pArray->swap = host_little_endian();
+      fmt = fmt.substr(1);
+    }
+  }
+
+  pArray->bytes = fmt == "B" || fmt == "c";
+  pArray->itemsize = (int) itemsize;
+
+  if (fmt == "?")
+    pArray->kind = 'b';
+  else if (fmt == "b" || fmt == "h" || fmt == "i" || fmt == "l" || fmt == "q" || fmt == "n")
+    pArray->kind = 'i';
+  else if (fmt == "B" || fmt == "c" || fmt == "H" || fmt == "I" || fmt == "L" || fmt == "Q" || fmt == "N")
+    pArray->kind = 'u';
+  else if (fmt == "f" || fmt == "d")
+    pArray->kind = 'f';
+  else if (fmt == "Zf" || fmt == "Zd")
+    pArray->kind = 'c';
+  else
+    return false;
+
+  return host_array_valid_kind(pArray->kind, pArray->itemsize);
+
+}
+
+void host_array_set_c_strides(HostArray* pArray) {
+  int nd = pArray->shape.size();
+  pArray->strides.resize(nd);
+  Py_ssize_t stride = pArray->itemsize;
+  for (int i = nd - 1; i >= 0; i--) {
+    pArray->strides[i] = stride;
+    stride *= pArray->shape[i];
+  }
+}
+
+bool host_array_f_contiguous(const HostArray& array) {
+  Py_ssize_t expected = array.itemsize;
+  for (std::size_t i = 0; i < array.shape.size(); i++) {
+    if (array.shape[i] != 1 && array.strides[i] != expected)
+      return false;
+    expected *= array.shape[i];
+  }
+  return true;
+}
+
+SEXPTYPE host_array_r_type(const HostArray& array) {
+  if (array.bytes)
+    return RAWSXP;
+  switch (array.kind) {
+  case 'b': return LGLSXP;
+  case 'i': return array.itemsize <= 4 ? INTSXP : REALSXP;
+  case 'u': return array.itemsize <= 2 ? INTSXP : REALSXP;
+  case 'f': return REALSXP;
+  case 'c': return CPLXSXP;
+  default:  return NILSXP;
+  }
+}
+
+template <typename T>
+T host_read(const char* p, bool swap) {
+  T value;
+  if (swap) {
+    char buffer[sizeof(T)];
+    for (std::size_t i = 0; i < sizeof(T); i++)
+      buffer[i] = p[sizeof(T) - 1 - i];
+    std::memcpy(&value, buffer, sizeof(T));
+  } else {
+    std::memcpy(&value, p, sizeof(T));
+  }
+  return value;
+}
+
+double host_read_real(const char* p, const HostArray& array) {
+
+  switch (array.kind) {
+  case 'b': return p[0] != 0;
+  case 'i':
+    switch (array.itemsize) {
+    case 1: return host_read<int8_t>(p, false);
+    case 2: return host_read<int16_t>(p, array.swap);
+    case 4: return host_read<int32_t>(p, array.swap);
+    case 8: return (double) host_read<int64_t>(p, array.swap);
+    }
+    break;
+  case 'u':
+    switch (array.itemsize) {
+    case 1: return host_read<uint8_t>(p, false);
+    case 2: return host_read<uint16_t>(p, array.swap);
+    case 4: return host_read<uint32_t>(p, array.swap);
+    case 8: return (double) host_read<uint64_t>(p, array.swap);
+    }
+    break;
+  case 'f':
+    if (array.itemsize == 4)
+      return host_read<float>(p, array.swap);
+    return host_read<double>(p, array.swap);
+  }
+
+  return NA_REAL;
+
+}
+
+Rcomplex host_read_complex(const char* p, const HostArray& array) {
+  Rcomplex value;
+  if (array.itemsize == 8) {
+    value.r = host_read<float>(p, array.swap);
+    value.i = host_read<float>(p + 4, array.swap);
+  } else {
+    value.r = host_read<double>(p, array.swap);
+    value.i = host_read<double>(p + 8, array.swap);
+  }
+  return value;
+}
+
+// convert host memory into an R vector; memory already laid out as R
+// would lay it out is viewed directly (retaining 'owner', which keeps the
+// memory valid) and otherwise copied in R's (column-major) order
+SEXP host_array_to_r(const HostArray& array, PyObject* owner) {
+
+  SEXPTYPE rtype = host_array_r_type(array);
+
+  int nd = array.shape.size();
+  R_xlen_t n = 1;
+  for (int i = 0; i < nd; i++) {
+    if (array.shape[i] < 0)
+      stop("array dimension %i has a negative extent", i + 1);
+    // R vectors can be long, but the extents of R arrays are integers
+    if (nd > 1 && array.shape[i] > INT_MAX)
+      stop("array dimension %i (of extent %.0f) is too large for an R array",
+           i + 1, (double) array.shape[i]);
+    if (array.shape[i] > 0 && n > R_XLEN_T_MAX / array.shape[i])
+      stop("array has too many elements for an R vector");
+    n *= array.shape[i];
+  }
+
+  // check whether the memory can be used as-is
+  bool native = !array.swap && host_array_f_contiguous(array);
+  switch (rtype) {
+  case REALSXP: native = native && array.kind == 'f' && array.itemsize == 8; break;
+  case INTSXP:  native = native && array.kind == 'i' && array.itemsize == 4; break;
+  case CPLXSXP: native = native && array.itemsize == 16; break;
+  case RAWSXP:  break;
+  default:      native = false; break;
+  }
+
+  std::size_t alignment = array.itemsize < 8 ? array.itemsize : 8;
+  bool aligned = ((uintptr_t) array.data) % alignment == 0;
+
+  RObject result;
+  if (native && aligned && n > 0 && reticulate::altrep::memory_view_available(rtype)) {
+    result = reticulate::altrep::memory_view(owner, array.data, n, rtype);
+  } else {
+
+    result = Rf_allocVector(rtype, n);
+    RETICULATE_STATS_COPY(n, n * array.itemsize);
+
+    if (native && n > 0) {
+      parallel_memcpy(DATAPTR(result), array.data, n * array.itemsize);
+    } else {
+
+      // walk the elements in column-major order
+      std::vector<Py_ssize_t> index(nd, 0);
+      const char* p = array.data;
+      for (R_xlen_t i = 0; i < n; i++) {
+
+        switch (rtype) {
+        case RAWSXP:  RAW(result)[i] = (Rbyte) p[0]; break;
+        case LGLSXP:  LOGICAL(result)[i] = p[0] != 0; break;
+        case INTSXP:  INTEGER(result)[i] = (int) host_read_real(p, array); break;
+        case REALSXP: REAL(result)[i] = host_read_real(p, array); break;
+        case CPLXSXP: COMPLEX(result)[i] = host_read_complex(p, array); break;
+        }
+
+        for (int d = 0; d < nd; d++) {
+          if (++index[d] < array.shape[d]) {
+            p += array.strides[d];
+            break;
+          }
+          p -= array.strides[d] * (array.shape[d] - 1);
+          index[d] = 0;
+        }
+
+      }
+
+    }
+
+  }
+
+  if (nd > 1) {
+    // (each extent was checked to fit above)
+    IntegerVector dims(nd);
+    for (int i = 0; i < nd; i++)
+      dims[i] = (int) array.shape[i];
+    result.attr("dim") = dims;
+  }
+
+  return result;
+
+}
+
+void host_buffer_release(PyObject* capsule) {
+  Py_buffer* view = (Py_buffer*) PyCapsule_GetPointer(capsule, "reticulate.buffer");
+  PyBuffer_Release(view);
+  delete view;
+}
+
+// objects supporting the buffer protocol (bytes, memoryview, array.array, ...)
+SEXP py_buffer_to_r(PyObject* x) {
+
+  if (!is_python3() || !PyObject_CheckBuffer(x))
+    return R_NilValue;
+
+  Py_buffer* view = new Py_buffer;
+  if (PyObject_GetBuffer(x, view, PyBUF_RECORDS_RO) != 0) {
+    PyErr_Clear();
+    delete view;
+    return R_NilValue;
+  }
+
+  // the buffer is released when the capsule is collected
+  PyObjectPtr owner(PyCapsule_New(view, "reticulate.buffer", host_buffer_release));
+  if (owner.is_null()) {
+    PyBuffer_Release(view);
+    delete view;
+    throw PythonException(py_fetch_error());
+  }
+
+  if (view->suboffsets != NULL)
+    return R_NilValue;
+
+  HostArray array;
+  array.data = (char*) view->buf;
+  if (!host_array_parse_format(view->format, view->itemsize, &array))
+    return R_NilValue;
+
+  for (int i = 0; i < view->ndim; i++) {
+    array.shape.push_back(view->shape[i]);
+    array.strides.push_back(view->strides[i]);
+  }
+
+  return host_array_to_r(array, owner);
+
+}
+
+// read a tuple of integers (e.g. the shape of an array interface)
+bool py_tuple_to_ssize(PyObject* tuple, std::vector<Py_ssize_t>* pValues) {
+
+  if (!PyTuple_Check(tuple))
+    return false;
+
+  // (C longs are 32-bit on Windows, so longs are read as Py_ssize_t; ints,
+  // on Python 2, always fit in a C long)
+  Py_ssize_t n = PyTuple_Size(tuple);
+  for (Py_ssize_t i = 0; i < n; i++) {
+    PyObject* item = PyTuple_GetItem(tuple, i);
+    Py_ssize_t value = !is_python3() && PyInt_Check(item) ?
+      PyInt_AsLong(item) : PyLong_AsSsize_t(item);
+    if (value == -1 && PyErr_Occurred()) {
+      PyErr_Clear();
+      return false;
+    }
+    pValues->push_back(value);
+  }
+
+  return true;
+
+}
+
+// objects implementing version 3 of the array interface with a data pointer
+// (interfaces which refer to a buffer are handled by the buffer protocol)
+SEXP py_array_interface_to_r(PyObject* x) {
+
+  if (!PyObject_HasAttrString(x, "__array_interface__"))
+    return R_NilValue;
+
+  PyObjectPtr interface(PyObject_GetAttrString(x, "__array_interface__"));
+  if (interface.is_null()) {
+    PyErr_Clear();
+    return R_NilValue;
+  }
+
+  if (!PyDict_Check(interface))
+    return R_NilValue;
+
+  // masked arrays aren't supported
+  PyObject* mask = PyDict_GetItemString(interface, "mask");
+  if (mask != NULL && !py_is_none(mask))
+    return R_NilValue;
+
+  PyObject* data = PyDict_GetItemString(interface, "data");
+  PyObject* typestr = PyDict_GetItemString(interface, "typestr");
+  PyObject* shape = PyDict_GetItemString(interface, "shape");
+  if (data == NULL || typestr == NULL || shape == NULL)
+    return R_NilValue;
+
+  if (!PyTuple_Check(data) || PyTuple_Size(data) != 2 || !is_python_str(typestr))
+    return R_NilValue;
+
+  HostArray array;
+  if (!host_array_parse_typestr(as_std_string(typestr), &array))
+    return R_NilValue;
+
+  array.data = (char*) PyLong_AsVoidPtr(PyTuple_GetItem(data, 0));
+  if (array.data == NULL && PyErr_Occurred()) {
+    PyErr_Clear();
+    return R_NilValue;
+  }
+
+  if (!py_tuple_to_ssize(shape, &array.shape))
+    return R_NilValue;
+
+  PyObject* strides = PyDict_GetItemString(interface, "strides");
+  if (strides == NULL || py_is_none(strides))
+    host_array_set_c_strides(&array);
+  else if (!py_tuple_to_ssize(strides, &array.strides) ||
+           array.strides.size() != array.shape.size())
+    return R_NilValue;
+
+  return host_array_to_r(array, x);
+
+}
+
+// the parts of dlpack.h needed to consume a DLPack capsule
+struct DLDevice { int32_t device_type; int32_t device_id; };
+struct DLDataType { uint8_t code; uint8_t bits; uint16_t lanes; };
+
+struct DLTensor {
+  void* data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t* shape;
+  int64_t* strides;
+  uint64_t byte_offset;
+};
+
+struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void* manager_ctx;
+  void (*deleter)(DLManagedTensor* self);
+};
+
+#define kDLCPU      1
+#define kDLCUDAHost 3
+#define kDLROCMHost 11
+
+void dlpack_release(PyObject* capsule) {
+  DLManagedTensor* managed =
+    (DLManagedTensor*) PyCapsule_GetPointer(capsule, "reticulate.dltensor");
+  if (managed->deleter != NULL)
+    managed->deleter(managed);
+}
+
+// objects implementing DLPack (e.g. PyTorch, JAX, or CuPy tensors); only
+// tensors residing in host memory can be converted
+SEXP py_dlpack_to_r(PyObject* x) {
+
+  if (!PyObject_HasAttrString(x, "__dlpack__"))
+    return R_NilValue;
+
+  PyObjectPtr capsule(PyObject_CallMethod(x, "__dlpack__", NULL));
+  if (capsule.is_null()) {
+    PyErr_Clear();
+    return R_NilValue;
+  }
+
+  // if we return without consuming the capsule, its destructor will
+  // release the tensor
+  if (!PyCapsule_IsValid(capsule, "dltensor"))
+    return R_NilValue;
+
+  DLManagedTensor* managed =
+    (DLManagedTensor*) PyCapsule_GetPointer(capsule, "dltensor");
+  const DLTensor& tensor = managed->dl_tensor;
+
+  int device = tensor.device.device_type;
+  if (device != kDLCPU && device != kDLCUDAHost && device != kDLROCMHost)
+    return R_NilValue;
+
+  const char kinds[] = { 'i', 'u', 'f', 0, 0, 'c', 'b' };
+  if (tensor.dtype.lanes != 1 || tensor.dtype.bits % 8 != 0 ||
+      tensor.dtype.code >= sizeof(kinds))
+    return R_NilValue;
+
+  HostArray array;
+  array.kind = kinds[tensor.dtype.code];
+  array.itemsize = tensor.dtype.bits / 8;
+  array.swap = false;
+  array.bytes = false;
+  if (!host_array_valid_kind(array.kind, array.itemsize))
+    return R_NilValue;
+
+  // take ownership of the tensor, as required by the protocol
+  if (PyCapsule_SetName(capsule, "used_dltensor") != 0)
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr owner(PyCapsule_New(managed, "reticulate.dltensor", dlpack_release));
+  if (owner.is_null()) {
+    if (managed->deleter != NULL)
+      managed->deleter(managed);
+    throw PythonException(py_fetch_error());
+  }
+
+  array.data = (char*) tensor.data + tensor.byte_offset;
+  for (int i = 0; i < tensor.ndim; i++)
+    array.shape.push_back(tensor.shape[i]);
+
+  // DLPack strides are given in elements (NULL means C-contiguous)
+  if (tensor.strides == NULL) {
+    host_array_set_c_strides(&array);
+  } else {
+    for (int i = 0; i < tensor.ndim; i++)
+      array.strides.push_back(tensor.strides[i] * array.itemsize);
+  }
+
+  return host_array_to_r(array, owner);
+
+}
+
+// convert objects exposing host memory to R vectors, or return R_NilValue
+// if the object doesn't expose (convertible) memory
+SEXP py_host_memory_to_r(PyObject* x) {
+
+  SEXP result = py_buffer_to_r(x);
+  if (result == R_NilValue)
+    result = py_array_interface_to_r(x);
+  if (result == R_NilValue)
+    result = py_dlpack_to_r(x);
+
+  return result;
+
+}
+
+// How py_to_r() converts an object, as determined by py_to_r_classify().
+enum PyToRKind {
+  PY_TO_R_LOGICAL,
+  PY_TO_R_INTEGER,
+  PY_TO_R_DOUBLE,
+  PY_TO_R_COMPLEX,
+  PY_TO_R_STRING,
+  PY_TO_R_LIST,
+  PY_TO_R_TUPLE,
+  PY_TO_R_DICT,
+  PY_TO_R_ARRAY,
+  PY_TO_R_ARRAY_SCALAR,
+  PY_TO_R_LIST_SUBCLASS,
+  PY_TO_R_MAPPING,
+  PY_TO_R_CALLABLE,
+  PY_TO_R_ITERATOR,
+  PY_TO_R_BYTEARRAY,
+  PY_TO_R_PANDAS_NA,
+  PY_TO_R_CAPSULE,
+  PY_TO_R_REGISTERED,  // by a converter registered for the type
+  PY_TO_R_OBJECT       // as a reference to the object
+};
+
+// Converters registered by other packages (through the C callable
+// "register_py_to_r", see reticulate_register_py_to_r()).
+typedef SEXP (*PyToRConverter)(PyObject* x, int convert);
+typedef std::unordered_map<PyObject*, PyToRConverter> PyToRConverters;
+PyToRConverters s_py_to_r_converters;
+
+// Table of the conversions chosen for Python types, so that py_to_r() needn't
+// classify every object it converts. Most of the checks made to classify an
+// object depend only on its type, and the rest (which consult the object's
+// attributes, e.g. `__iter__` and `__next__`) do too when the type looks up
+// attributes in the usual way, so the conversion chosen for the first object
+// of such a type is reused for the others. Entries are validated against the
+// type's version tag, which changes whenever the type is modified.
+struct PyToRDispatchEntry {
+  unsigned int version;
+  PyToRKind kind;
+  PyToRConverter converter;
+};
+
+typedef std::unordered_map<PyObject*, PyToRDispatchEntry> PyToRDispatch;
+PyToRDispatch s_py_to_r_dispatch;
+
+const std::size_t s_py_to_r_dispatch_max_size = 4096;
+
+// are the attribute checks made by py_to_r_classify() for this object
+// answered the same way for every object of its type?
+bool py_type_has_plain_attributes(PyObject* x) {
+
+  // types with __getattr__ (or their own getattro, e.g. proxies) may answer
+  // differently for each object
+  void* getattro = ((PyTypeObject_fields*) Py_TYPE(x))->tp_slots[12];
+  if (PyObject_GenericGetAttr == NULL || getattro != (void*) PyObject_GenericGetAttr)
+    return false;
+
+  // as may types which override __class__
+  PyObjectPtr cls(PyObject_GetAttrString(x, "__class__"));
+  if (cls.is_null()) {
+    PyErr_Clear();
+    return false;
+  }
+
+  return cls.get() == (PyObject*) Py_TYPE(x);
+
+}
+
+// can objects of this type have attributes of their own, in an instance
+// __dict__? (tp_dictoffset is the 31st slot of PyTypeObject; as of Python
+// 3.11 the dict may instead be managed by Python, as flagged)
+bool py_type_has_instance_dict(PyObject* x) {
+  PyTypeObject* type = Py_TYPE(x);
+  Py_ssize_t offset = (Py_ssize_t) ((PyTypeObject_fields*) type)->tp_slots[30];
+  return offset != 0 || PyType_HasFeature(type, Py_TPFLAGS_MANAGED_DICT);
+}
+
+PyToRKind py_to_r_classify(PyObject* x, bool* cacheable) {
+
+  *cacheable = true;
+
+  // check for scalars
+  switch (r_scalar_type(x)) {
+  case LGLSXP:  return PY_TO_R_LOGICAL;
+  case INTSXP:  return PY_TO_R_INTEGER;
+  case REALSXP: return PY_TO_R_DOUBLE;
+  case CPLXSXP: return PY_TO_R_COMPLEX;
+  case STRSXP:  return PY_TO_R_STRING;
+  default:      break;
+  }
+
+  if (PyList_CheckExact(x))
+    return PY_TO_R_LIST;
+
+  if (PyTuple_CheckExact(x) && !PyObject_HasAttrString(x, "_fields"))
+    return PY_TO_R_TUPLE;
+
+  if (PyDict_CheckExact(x))
+    return PY_TO_R_DICT;
+
+  if (isPyArray(x))
+    return PY_TO_R_ARRAY;
+
+  if (isPyArrayScalar(x))
+    return PY_TO_R_ARRAY_SCALAR;
+
+  if (PyList_Check(x))
+    return PY_TO_R_LIST_SUBCLASS;
+
+  // the remaining checks consult the object itself (capsules are told apart
+  // by their names, which are not part of their type)
+  *cacheable =
+    std::strcmp(Py_TYPE(x)->tp_name, "PyCapsule") != 0 &&
+    py_type_has_plain_attributes(x);
+
+  if (PyObject_IsInstance(x, Py_DictClass))
+    return PY_TO_R_MAPPING;
+
+  if (PyCallable_Check(x) == 1)
+    return PY_TO_R_CALLABLE;
+
+  // the remaining probes may be answered by the object's own __dict__ (e.g.
+  // an instance given a __call__ or __next__ attribute), and so, as may
+  // everything classified after them, differ between objects of the type
+  if (py_type_has_instance_dict(x))
+    *cacheable = false;
+
+  if (PyObject_HasAttrString(x, "__call__"))
+    return PY_TO_R_CALLABLE;
+
+  if (PyObject_HasAttrString(x, "__iter__") &&
+      (PyObject_HasAttrString(x, "next") ||
+       PyObject_HasAttrString(x, "__next__")))
+    return PY_TO_R_ITERATOR;
+
+  if (PyByteArray_Check(x))
+    return PY_TO_R_BYTEARRAY;
+
+  if (is_pandas_na(x))
+    return PY_TO_R_PANDAS_NA;
+
+  if (is_r_object_capsule(x))
+    return PY_TO_R_CAPSULE;
+
+  return PY_TO_R_OBJECT;
+
+}
+
+PyToRKind py_to_r_kind(PyObject* x, PyToRConverter* converter) {
+
+  PyObject* type = (PyObject*) Py_TYPE(x);
+  unsigned int version = py_type_version_tag(type);
+
+  PyToRDispatch::iterator it = s_py_to_r_dispatch.find(type);
+  if (it != s_py_to_r_dispatch.end()) {
+    if (version != 0 && it->second.version == version) {
+      *converter = it->second.converter;
+      return it->second.kind;
+    }
+    s_py_to_r_dispatch.erase(it);
+  }
+
+  PyToRKind kind;
+  bool cacheable = true;
+
+  PyToRConverters::iterator registered = s_py_to_r_converters.find(type);
+  if (registered != s_py_to_r_converters.end()) {
+    kind = PY_TO_R_REGISTERED;
+    *converter = registered->second;
+  } else {
+    kind = py_to_r_classify(x, &cacheable);
+  }
+
+  if (cacheable && version != 0) {
+    if (s_py_to_r_dispatch.size() >= s_py_to_r_dispatch_max_size)
+      s_py_to_r_dispatch.clear();
+    PyToRDispatchEntry entry = { version, kind, *converter };
+    s_py_to_r_dispatch[type] = entry;
+  }
+
+  return kind;
+
+}
+
+// Register a converter for the objects of (exactly) a Python type, which
+// py_to_r() then calls instead of converting objects of the type itself;
+// registering a NULL converter removes a type's converter. Other packages
+// call this through R_GetCCallable("reticulate", "register_py_to_r"), from
+// the main thread while holding the GIL.
+//
+// Converters are called as converter(x, convert), with a borrowed reference
+// to the object, and return the R object it's converted to, or NULL to
+// decline to convert it (with a Python error set, to signal an error). They
+// must not raise R errors.
+extern "C" int reticulate_register_py_to_r(PyObject* type, PyToRConverter converter) {
+
+  if (type == NULL || !PyType_Check(type))
+    return -1;
+
+  PyToRConverters::iterator it = s_py_to_r_converters.find(type);
+  if (it != s_py_to_r_converters.end()) {
+    if (converter == NULL) {
+      Py_DecRef(it->first);
+      s_py_to_r_converters.erase(it);
+    } else {
+      it->second = converter;
+    }
+  } else if (converter != NULL) {
+    Py_IncRef(type);
+    s_py_to_r_converters[type] = converter;
+  }
+
+  s_py_to_r_dispatch.erase(type);
+  return 0;
+
+}
+
+// [[Rcpp::init]]
+void reticulate_init_ccallables(DllInfo* dll) {
+  R_RegisterCCallable("reticulate", "register_py_to_r",
+                      (DL_FUNC) reticulate_register_py_to_r);
+}
+
+// convert a python object to an R object
+SEXP py_to_r(PyObject* x, bool convert) {
+
+  RETICULATE_STATS_TIME(PY_TO_R);
+  RETICULATE_STATS_PY_TYPE(
+    isPyArray(x) ?
+      PyArray_DESCR((PyArrayObject*) x)->typeobj->tp_name :
+      Py_TYPE(x)->tp_name
+  );
+
+  // NULL for Python None
+  if (py_is_none(x))
+    return R_NilValue;
+
+  PyToRConverter converter = NULL;
+  switch (py_to_r_kind(x, &converter)) {
+
+  // scalars
+  case PY_TO_R_LOGICAL:
+    return LogicalVector::create(x == Py_True);
+
+  case PY_TO_R_INTEGER:
+    return IntegerVector::create(PyInt_AsLong(x));
+
+  case PY_TO_R_DOUBLE:
+    return NumericVector::create(PyFloat_AsDouble(x));
+
+  case PY_TO_R_COMPLEX: {
+    Rcomplex cplx;
+    cplx.r = PyComplex_RealAsDouble(x);
+    cplx.i = PyComplex_ImagAsDouble(x);
+    return ComplexVector::create(cplx);
+  }
+
+  case PY_TO_R_STRING:
+    return CharacterVector::create(as_utf8_r_string(x));
+
+  // list
+  case PY_TO_R_LIST: {
+
+    Py_ssize_t len = PyList_Size(x);
     int scalarType = scalar_list_type(x);
     if (scalarType == REALSXP) {
       Rcpp::NumericVector vec(len);
@@ -1056,7 +2491,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // tuple (but don't convert namedtuple as it's often a custom class)
-  else if (PyTuple_CheckExact(x) && !PyObject_HasAttrString(x, "_fields")) {
+  case PY_TO_R_TUPLE: {
     Py_ssize_t len = PyTuple_Size(x);
     Rcpp::List list(len);
     for (Py_ssize_t i = 0; i<len; i++)
@@ -1065,35 +2500,38 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // dict
-  else if (PyDict_CheckExact(x)) {
-
-    // copy the dict and allocate
-    PyObjectPtr dict(PyDict_Copy(x));
-    Py_ssize_t size = PyDict_Size(dict);
-    std::vector<std::string> names(size);
+  case PY_TO_R_DICT: {
+
+    // iterate over the dict itself rather than a copy; conversion could in
+    // principle run code that modifies it, so hold on to the entries while
+    // converting them, and fail (as Python's own dict iterators do) if the
+    // dict changes size
+    Py_ssize_t size = PyDict_Size(x);
+    CharacterVector names(size);
     Rcpp::List list(size);
 
-    // iterate over dict
     PyObject *key, *value;
     Py_ssize_t pos = 0;
     Py_ssize_t idx = 0;
-    while (PyDict_Next(dict, &pos, &key, &value)) {
-      if (is_python_str(key)) {
-        names[idx] = as_utf8_r_string(key);
-      } else {
-        PyObjectPtr str(PyObject_Str(key));
-        names[idx] = as_utf8_r_string(str);
-      }
+    while (PyDict_Next(x, &pos, &key, &value)) {
+      if (idx >= size)
+        stop("dictionary changed size during conversion");
+      Py_IncRef(key);
+      Py_IncRef(value);
+      PyObjectPtr keyPtr(key), valuePtr(value);
+      SET_STRING_ELT(names, idx, as_r_name(key));
       list[idx] = py_to_r(value, convert);
       idx++;
     }
+    if (idx != size || PyDict_Size(x) != size)
+      stop("dictionary changed size during conversion");
     list.names() = names;
     return list;
 
   }
 
   // numpy array
-  else if (isPyArray(x)) {
+  case PY_TO_R_ARRAY: {
 
     // R array to return
     RObject rArray = R_NilValue;
@@ -1105,19 +2543,41 @@ SEXP py_to_r(PyObject* x, bool convert) {
     // a 1-dim for conversion to R (will end up with a single
     // element R vector)
     npy_intp len = PyArray_SIZE(array);
-    int nd = PyArray_NDIM(array);
-    IntegerVector dimsVector(nd);
-    if (nd > 0) {
-      npy_intp *dims = PyArray_DIMS(array);
-      for (int i = 0; i<nd; i++)
-        dimsVector[i] = dims[i];
-    } else {
-      dimsVector.push_back(1);
+    RObject dimsVector(numpy_r_dims(array));
+
+    // if the array's memory is already laid out as R would lay it out,
+    // return a vector which views that memory directly (opt-in, since
+    // modifications made to the array from Python remain visible in R
+    // until R itself writes to the vector)
+    if (option_is_true("reticulate.numpy_altrep")) {
+
+      // object arrays can only be viewed if they contain only strings
+      SEXPTYPE viewType = reticulate::altrep::numpy_view_type(array);
+      if (viewType == STRSXP &&
+          PyArray_TYPE(array) == NPY_OBJECT &&
+          !is_string_object_array((PyObject**) PyArray_DATA(array), len))
+      {
+        viewType = NILSXP;
+      }
+
+      if (viewType != NILSXP) {
+        rArray = reticulate::altrep::numpy_view(array, viewType);
+        rArray.attr("dim") = dimsVector;
+        return rArray;
+      }
     }
 
     // determine the target type of the array
     int typenum = narrow_array_typenum(array);
 
+    // numeric arrays are copied directly into the R result
+    SEXPTYPE rtype = numpy_r_type(typenum);
+    if (rtype != NILSXP) {
+      rArray = numpy_r_alloc(rtype, len, dimsVector);
+      numpy_copy_into(array, rArray);
+      return rArray;
+    }
+
     // cast it to a fortran array (PyArray_CastToType steals the descr)
     // (note that we will decref the copied array below)
     PyArray_Descr* descr = PyArray_DescrFromType(typenum);
@@ -1131,43 +2591,6 @@ SEXP py_to_r(PyObject* x, bool convert) {
     // copy the data as required per-type
     switch(typenum) {
 
-      case NPY_BOOL: {
-        npy_bool* pData = (npy_bool*)PyArray_DATA(array);
-        rArray = Rf_allocArray(LGLSXP, dimsVector);
-        for (int i=0; i<len; i++)
-          LOGICAL(rArray)[i] = pData[i];
-        break;
-      }
-
-      case NPY_LONG: {
-        npy_long* pData = (npy_long*)PyArray_DATA(array);
-        rArray = Rf_allocArray(INTSXP, dimsVector);
-        for (int i=0; i<len; i++)
-          INTEGER(rArray)[i] = pData[i];
-        break;
-      }
-
-      case NPY_DOUBLE: {
-        npy_double* pData = (npy_double*)PyArray_DATA(array);
-        rArray = Rf_allocArray(REALSXP, dimsVector);
-        for (int i=0; i<len; i++)
-          REAL(rArray)[i] = pData[i];
-        break;
-      }
-
-      case NPY_CDOUBLE: {
-        npy_complex128* pData = (npy_complex128*)PyArray_DATA(array);
-        rArray = Rf_allocArray(CPLXSXP, dimsVector);
-        for (int i=0; i<len; i++) {
-          npy_complex128 data = pData[i];
-          Rcomplex cpx;
-          cpx.r = data.real;
-          cpx.i = data.imag;
-          COMPLEX(rArray)[i] = cpx;
-        }
-        break;
-      }
-
       case NPY_STRING:
       case NPY_UNICODE: {
 
@@ -1184,11 +2607,11 @@ SEXP py_to_r(PyObject* x, bool convert) {
           throw PythonException(py_fetch_error());
         }
 
-        rArray = Rf_allocArray(STRSXP, dimsVector);
+        rArray = numpy_r_alloc(STRSXP, len, dimsVector);
         RObject protectArray(rArray);
 
 
-        for (int i=0; i<len; i++) {
+        for (npy_intp i = 0; i < len; i++) {
           PyObjectPtr el(PyIter_Next(iter)); // returns an scalar array.
           PyObjectPtr pyStr(PyObject_CallMethod(el, "item", NULL));
           if (pyStr.is_null()) {
@@ -1204,19 +2627,9 @@ SEXP py_to_r(PyObject* x, bool convert) {
         // get python objects
         PyObject** pData = (PyObject**)PyArray_DATA(array);
 
-        // check for all strings
-        bool allStrings = true;
-        for (npy_intp i=0; i<len; i++) {
-          auto el = pData[i];
-          if (!is_python_str(el) && !is_pandas_na_like(el)) {
-            allStrings = false;
-            break;
-          }
-        }
-
         // return a character vector if it's all strings
-        if (allStrings) {
-          rArray = Rf_allocArray(STRSXP, dimsVector);
+        if (is_string_object_array(pData, len)) {
+          rArray = numpy_r_alloc(STRSXP, len, dimsVector);
           RObject protectArray(rArray);
           for (npy_intp i = 0; i < len; i++)
             set_string_element(rArray, i, pData[i]);
@@ -1224,7 +2637,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
         }
 
         // otherwise return a list of objects
-        rArray = Rf_allocArray(VECSXP, dimsVector);
+        rArray = numpy_r_alloc(VECSXP, len, dimsVector);
         RObject protectArray(rArray);
         for (npy_intp i = 0; i < len; i++) {
           SEXP data = py_to_r(pData[i], convert);
@@ -1241,7 +2654,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // check for numpy scalar
-  else if (isPyArrayScalar(x)) {
+  case PY_TO_R_ARRAY_SCALAR: {
 
     // determine the type to convert to
     PyArray_DescrPtr descrPtr(PyArray_DescrFromScalar(x));
@@ -1292,7 +2705,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
 
   }
 
-  else if (PyList_Check(x)) {
+  case PY_TO_R_LIST_SUBCLASS: {
     // didn't pass PyList_CheckExact(), but does pass PyList_Check()
     // so it's an object that subclasses list.
     // (This type of subclassed list is used by tensorflow for lists of layers
@@ -1316,7 +2729,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
     return list;
   }
 
-  else if (PyObject_IsInstance(x, Py_DictClass)) {
+  case PY_TO_R_MAPPING: {
     // This check is kind of slow since it calls back into evaluating Python code instead of
     // merely consulting the object header, but it is the only reliable way that works
     // for tensorflow._DictWrapper,
@@ -1332,7 +2745,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
     PyObjectPtr items(PyMapping_Items(x));
 
     Py_ssize_t size = PyObject_Size(items);
-    std::vector<std::string> names(size);
+    CharacterVector names(size);
     Rcpp::List list(size);
 
     for (Py_ssize_t idx = 0; idx < size; idx++) {
@@ -1340,12 +2753,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
       PyObject *key = PyTuple_GetItem(item, 0); // borrowed ref
       PyObject *value = PyTuple_GetItem(item, 1); // borrowed ref
 
-      if (is_python_str(key)) {
-        names[idx] = as_utf8_r_string(key);
-      } else {
-        PyObjectPtr str(PyObject_Str(key));
-        names[idx] = as_utf8_r_string(str);
-      }
+      SET_STRING_ELT(names, idx, as_r_name(key));
       list[idx] = py_to_r(value, convert);
     }
     list.names() = names;
@@ -1353,7 +2761,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // callable
-  else if (py_is_callable(x)) {
+  case PY_TO_R_CALLABLE: {
 
     // reference to underlying python object
     Py_IncRef(x);
@@ -1375,9 +2783,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // iterator/generator
-  else if (PyObject_HasAttrString(x, "__iter__") &&
-           (PyObject_HasAttrString(x, "next") ||
-            PyObject_HasAttrString(x, "__next__"))) {
+  case PY_TO_R_ITERATOR: {
 
     // return it raw but add a class so we can create S3 methods for it
     Py_IncRef(x);
@@ -1385,7 +2791,7 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // bytearray
-  else if (PyByteArray_Check(x)) {
+  case PY_TO_R_BYTEARRAY: {
 
     if (PyByteArray_Size(x) == 0)
       return RawVector();
@@ -1397,22 +2803,44 @@ SEXP py_to_r(PyObject* x, bool convert) {
   }
 
   // pandas array
-  else if (is_pandas_na(x)) {
+  case PY_TO_R_PANDAS_NA: {
     return NumericVector::create(R_NaReal);
   }
 
-  else if (is_r_object_capsule(x)) {
+  case PY_TO_R_CAPSULE: {
     return py_capsule_read(x);
   }
 
+  // converters registered by other packages return NULL to decline
+  // converting an object (or, with a Python error set, to signal an error)
+  case PY_TO_R_REGISTERED: {
+    SEXP converted = converter(x, convert);
+    if (converted != NULL)
+      return converted;
+    if (PyErr_Occurred())
+      throw PythonException(py_fetch_error());
+    break;
+  }
+
+  case PY_TO_R_OBJECT:
+    break;
+
+  }
+
   // default is to return opaque wrapper to python object. we pass convert = true
   // because if we hit this code then conversion has been either implicitly
   // or explicitly requested.
-  else {
-    Py_IncRef(x);
-    return py_ref(x, true);
+  //
+  // objects exporting host memory can optionally be converted to vectors
+  if (option_is_true("reticulate.buffer_conversion")) {
+    SEXP converted = py_host_memory_to_r(x);
+    if (converted != R_NilValue)
+      return converted;
   }
 
+  Py_IncRef(x);
+  return py_ref(x, true);
+
 }
 
 /* stretchy list, modified from R sources
@@ -1565,20 +2993,41 @@ bool is_convertible_to_numpy(RObject x) {
     type == STRSXP;
 }
 
+// narrow an R logical vector to a NumPy bool array (in parallel, for
+// long vectors)
+struct NarrowLogicalRange {
+  const int* src;
+  bool* dst;
+};
+
+void narrow_logical_range(void* data, R_xlen_t begin, R_xlen_t end) {
+  NarrowLogicalRange* range = (NarrowLogicalRange*) data;
+  for (R_xlen_t i = begin; i < end; i++)
+    range->dst[i] = range->src[i];
+}
+
+void numpy_narrow_logical(const int* src, bool* dst, R_xlen_t n) {
+  NarrowLogicalRange range = { src, dst };
+  double bytes = (double) n * (sizeof(int) + sizeof(bool));
+  reticulate::parallel::for_range(n, bytes, narrow_logical_range, &range);
+}
+
 PyObject* r_to_py_numpy(RObject x, bool convert) {
 
   int type = x.sexp_type();
   SEXP sexp = x.get__();
 
-  // figure out dimensions for resulting array
-  IntegerVector dimensions = x.hasAttribute("dim")
-    ? x.attr("dim")
-    : IntegerVector::create(Rf_xlength(x));
-
-  int nd = dimensions.length();
-  std::vector<npy_intp> dims(nd);
-  for (int i = 0; i < nd; i++)
-    dims[i] = dimensions[i];
+  // figure out dimensions for resulting array (vectors without a "dim"
+  // attribute may be long vectors)
+  std::vector<npy_intp> dims;
+  if (x.hasAttribute("dim")) {
+    IntegerVector dimensions = x.attr("dim");
+    for (R_xlen_t i = 0; i < dimensions.length(); i++)
+      dims.push_back(dimensions[i]);
+  } else {
+    dims.push_back(Rf_xlength(x));
+  }
+  int nd = dims.size();
 
   // get pointer + type for underlying data
   int typenum;
@@ -1616,9 +3065,11 @@ PyObject* r_to_py_numpy(RObject x, bool convert) {
   if (typenum == NPY_BOOL) {
     R_xlen_t n = XLENGTH(sexp);
     bool* converted = (bool*) PyArray_malloc(n * sizeof(bool));
-    for (R_xlen_t i = 0; i < n; i++)
-      converted[i] = LOGICAL(sexp)[i];
+    if (converted == NULL && n > 0)
+      stop("failed to allocate memory for a NumPy array of %.0f elements", (double) n);
+    numpy_narrow_logical(LOGICAL(sexp), converted, n);
     data = converted;
+    RETICULATE_STATS_COPY(n, n * sizeof(bool));
     flags |= NPY_ARRAY_OWNDATA;
   }
 
@@ -1668,6 +3119,97 @@ PyObject* r_to_py_numpy(RObject x, bool convert) {
 
 }
 
+// when NumPy is not available, expose the memory of an integer or double
+// vector to Python through a read-only memoryview. the view is built on a
+// ctypes array pointing at the R data, and that array holds a capsule which
+// keeps the R vector alive for as long as the memoryview is reachable.
+// returns NULL if the vector cannot be exposed this way
+PyObject* r_to_py_memoryview(RObject x) {
+
+  if (!is_python3())
+    return NULL;
+
+  int type = x.sexp_type();
+  SEXP sexp = x.get__();
+
+  const char* ctype;
+  const char* format;
+  void* data;
+  if (type == REALSXP) {
+    ctype = "c_double";
+    format = "d";
+    data = REAL(sexp);
+  } else if (type == INTSXP && sizeof(int) == 4) {
+    ctype = "c_int32";
+    format = "i";
+    data = INTEGER(sexp);
+  } else {
+    return NULL;
+  }
+
+  PyObjectPtr ctypes(py_import("ctypes"));
+  if (ctypes.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr element(PyObject_GetAttrString(ctypes, ctype));
+  if (element.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr arrayType(PyObject_CallMethod(element, "__mul__", "n",
+                                            (Py_ssize_t) XLENGTH(sexp)));
+  if (arrayType.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr array(PyObject_CallMethod(arrayType, "from_address", "n",
+                                        (Py_ssize_t) data));
+  if (array.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr capsule(py_capsule_new(x));
+  if (PyObject_SetAttrString(array, "_r_object", capsule) != 0)
+    throw PythonException(py_fetch_error());
+
+  // ctypes reports a non-native format string (e.g. '<d'); cast through
+  // bytes so the view carries the plain native format
+  PyObjectPtr builtins(py_import("builtins"));
+  if (builtins.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr view(PyObject_CallMethod(builtins, "memoryview", "O",
+                                       array.get()));
+  if (view.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr bytes(PyObject_CallMethod(view, "cast", "s", "B"));
+  if (bytes.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr typed(PyObject_CallMethod(bytes, "cast", "s", format));
+  if (typed.is_null())
+    throw PythonException(py_fetch_error());
+
+  // memoryview.toreadonly() is only available in Python >= 3.8; without it
+  // the view would let Python write to the R vector, so it's copied instead
+  if (!PyObject_HasAttrString(typed, "toreadonly"))
+    return NULL;
+
+  PyObject* readonly = PyObject_CallMethod(typed, "toreadonly", NULL);
+  if (readonly == NULL)
+    throw PythonException(py_fetch_error());
+
+  return readonly;
+
+}
+
+// should atomic vectors (other than scalars) be converted to NumPy arrays
+// rather than lists? controlled by the 'reticulate.vector_conversion' option
+bool vector_conversion_numpy() {
+  SEXP valueSEXP = Rf_GetOption(Rf_install("reticulate.vector_conversion"), R_BaseEnv);
+  return TYPEOF(valueSEXP) == STRSXP &&
+    Rf_length(valueSEXP) == 1 &&
+    std::strcmp(CHAR(STRING_ELT(valueSEXP, 0)), "numpy") == 0;
+}
+
 PyObject* r_to_py_cpp(RObject x, bool convert);
 
 PyObject* r_to_py(RObject x, bool convert) {
@@ -1675,6 +3217,8 @@ PyObject* r_to_py(RObject x, bool convert) {
   if (OBJECT(x) == 0)
     return r_to_py_cpp(x, convert);
 
+  RETICULATE_STATS_TIME(R_TO_PY_DISPATCH);
+
   // get a reference to the R version of r_to_py
   Rcpp::Environment pkgEnv = Rcpp::Environment::namespace_env("reticulate");
   Rcpp::Function r_to_py_fn = pkgEnv["r_to_py"];
@@ -1720,6 +3264,9 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
   int type = x.sexp_type();
   SEXP sexp = x.get__();
 
+  RETICULATE_STATS_TIME(R_TO_PY);
+  RETICULATE_STATS_R_TYPE(type);
+
   // NULL becomes python None
   // (Py_IncRef since PyTuple_SetItem will steal the passed reference)
   if (x.isNULL()) {
@@ -1748,17 +3295,27 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
     return r_to_py_numpy(x, convert);
   }
 
+  // optionally convert non-scalar atomic vectors to 1-d NumPy arrays (or,
+  // when NumPy is unavailable, read-only memoryviews) rather than lists
+  if (Rf_xlength(sexp) > 1 && vector_conversion_numpy()) {
+    if (is_convertible_to_numpy(x))
+      return r_to_py_numpy(x, convert);
+    PyObject* view = r_to_py_memoryview(x);
+    if (view != NULL)
+      return view;
+  }
+
   // integer (pass length 1 vectors as scalars, otherwise pass list)
   if (type == INTSXP) {
 
     // handle scalars
-    if (LENGTH(sexp) == 1) {
+    if (XLENGTH(sexp) == 1) {
       int value = INTEGER(sexp)[0];
       return PyInt_FromLong(value);
     }
 
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       int value = INTEGER(sexp)[i];
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, PyInt_FromLong(value));
@@ -1774,13 +3331,13 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
   if (type == REALSXP) {
 
     // handle scalars
-    if (LENGTH(sexp) == 1) {
+    if (XLENGTH(sexp) == 1) {
       double value = REAL(sexp)[0];
       return PyFloat_FromDouble(value);
     }
 
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       double value = REAL(sexp)[i];
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, PyFloat_FromDouble(value));
@@ -1796,13 +3353,13 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
   if (type == CPLXSXP) {
 
     // handle scalars
-    if (LENGTH(sexp) == 1) {
+    if (XLENGTH(sexp) == 1) {
       Rcomplex cplx = COMPLEX(sexp)[0];
       return PyComplex_FromDoubles(cplx.r, cplx.i);
     }
 
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       Rcomplex cplx = COMPLEX(sexp)[i];
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, PyComplex_FromDoubles(cplx.r, cplx.i));
@@ -1818,13 +3375,13 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
   if (type == LGLSXP) {
 
     // handle scalars
-    if (LENGTH(sexp) == 1) {
+    if (XLENGTH(sexp) == 1) {
       int value = LOGICAL(sexp)[0];
       return PyBool_FromLong(value);
     }
 
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       int value = LOGICAL(sexp)[i];
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, PyBool_FromLong(value));
@@ -1840,12 +3397,12 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
   if (type == STRSXP) {
 
     // handle scalars
-    if (LENGTH(sexp) == 1) {
+    if (XLENGTH(sexp) == 1) {
       return as_python_str(STRING_ELT(sexp, 0));
     }
 
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, as_python_str(STRING_ELT(sexp, i)));
       if (res != 0)
@@ -1876,10 +3433,10 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
       PyObjectPtr dict(PyDict_New());
       CharacterVector names = x.attr("names");
       SEXP namesSEXP = names;
-      for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
-        const char* name = Rf_translateChar(STRING_ELT(namesSEXP, i));
+      for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
+        PyObjectPtr name(as_python_name(STRING_ELT(namesSEXP, i)));
         PyObjectPtr item(r_to_py(RObject(VECTOR_ELT(sexp, i)), convert));
-        int res = PyDict_SetItemString(dict, name, item);
+        int res = PyDict_SetItem(dict, name, item);
         if (res != 0)
           throw PythonException(py_fetch_error());
       }
@@ -1889,8 +3446,8 @@ PyObject* r_to_py_cpp(RObject x, bool convert) {
     }
 
     // create a list if there are no names
-    PyObjectPtr list(PyList_New(LENGTH(sexp)));
-    for (R_xlen_t i = 0; i<LENGTH(sexp); i++) {
+    PyObjectPtr list(PyList_New(XLENGTH(sexp)));
+    for (R_xlen_t i = 0; i<XLENGTH(sexp); i++) {
       PyObject* item = r_to_py(RObject(VECTOR_ELT(sexp, i)), convert);
       // NOTE: reference to added value is "stolen" by the list
       int res = PyList_SetItem(list, i, item);
@@ -1956,6 +3513,8 @@ PyObjectRef r_to_py_impl(RObject object, bool convert) {
 
 extern "C" PyObject* call_r_function(PyObject *self, PyObject* args, PyObject* keywords)
 {
+  RETICULATE_STATS_TIME(R_CALL);
+
   // the first argument is always the capsule containing the R function to call
   PyObject* capsule = PyTuple_GetItem(args, 0);
   RObject rFunction = py_capsule_read(capsule);
@@ -2032,6 +3591,233 @@ extern "C" PyObject* call_r_function(PyObject *self, PyObject* args, PyObject* k
   return out;
 }
 
+// Python -> R callbacks for functions created with py_func(f, fast = TRUE).
+//
+// These skip the R-level call_r_function() wrapper: the call is evaluated
+// directly, with R errors caught at the C level, and the result (or error)
+// is returned (or raised) directly rather than as a (value, error) tuple.
+// The call object is reused from callback to callback with the same number
+// of positional arguments (and no keyword arguments).
+
+const char *fast_r_function_string = "reticulate.fast_r_function";
+
+struct FastRFunction {
+
+  // a list with the function, the most recently used call, and the result
+  // (or error condition) of the most recent callback, and the token
+  // returned by Rcpp_precious_preserve() when preserving it
+  SEXP state;
+  SEXP token;
+  bool convert;
+
+  // is the call object in use (by a callback further up the stack)?
+  bool busy;
+
+};
+
+enum FastRFunctionSlot {
+  FAST_R_FUNCTION = 0,
+  FAST_R_CALL,
+  FAST_R_RESULT,
+  FAST_R_CONDITION
+};
+
+void fast_r_function_free(PyObject* capsule) {
+  FastRFunction* function =
+    (FastRFunction*) PyCapsule_GetPointer(capsule, fast_r_function_string);
+  if (function == NULL)
+    return;
+  Rcpp_precious_remove_main_thread(function->token);
+  delete function;
+}
+
+SEXP fast_r_function_eval(void* data) {
+  SEXP call = VECTOR_ELT((SEXP) data, FAST_R_CALL);
+  return Rf_eval(call, R_GlobalEnv);
+}
+
+SEXP fast_r_function_error(SEXP condition, void* data) {
+  SET_VECTOR_ELT((SEXP) data, FAST_R_CONDITION, condition);
+  return R_NilValue;
+}
+
+void fast_r_function_toplevel(void* data) {
+  SEXP state = (SEXP) data;
+  SEXP result = R_tryCatchError(
+    fast_r_function_eval, data,
+    fast_r_function_error, data);
+  SET_VECTOR_ELT(state, FAST_R_RESULT, result);
+}
+
+// raise a Python exception of a builtin type, with an optional message
+void set_builtin_error(const char* type, const char* message) {
+  PyObjectPtr builtins(py_import(is_python3() ? "builtins" : "__builtin__"));
+  PyObjectPtr exception(PyObject_GetAttrString(builtins, type));
+  if (message == NULL) {
+    PyErr_SetNone(exception);
+  } else {
+    PyObjectPtr value(as_python_str(message));
+    PyErr_SetObject(exception, value);
+  }
+}
+
+// raise an R condition as a Python exception
+void fast_r_function_raise(SEXP condition) {
+  try {
+    PyObjectPtr exception(r_to_py(condition, true));
+    PyErr_SetObject((PyObject*) Py_TYPE(exception.get()), exception);
+  } catch (...) {
+    set_builtin_error("RuntimeError", "(Error converting R condition)");
+  }
+}
+
+SEXP fast_r_function_call(FastRFunction* function, PyObject* args, PyObject* keywords) {
+
+  SEXP state = function->state;
+  bool convert = function->convert;
+  Py_ssize_t n = PyTuple_Size(args);
+
+  // reuse the previous call when it has the right shape, and isn't in use by
+  // a callback further up the stack; only calls without keyword arguments
+  // are kept for reuse
+  SEXP previous = VECTOR_ELT(state, FAST_R_CALL);
+  bool cache = !function->busy && keywords == NULL;
+  bool reuse = cache && previous != R_NilValue && Rf_length(previous) == n + 1;
+
+  SEXP call = previous;
+  if (!reuse) {
+    Py_ssize_t nkeywords = keywords == NULL ? 0 : PyDict_Size(keywords);
+    SEXP callArgs = PROTECT(Rf_allocList(n + nkeywords));
+    call = Rf_lcons(VECTOR_ELT(state, FAST_R_FUNCTION), callArgs);
+    UNPROTECT(1);
+  }
+
+  // (conversions below may throw, so protect with RObject)
+  RObject protectCall(call), protectPrevious(previous);
+
+  SEXP node = CDR(call);
+  for (Py_ssize_t i = 0; i < n; i++, node = CDR(node)) {
+    PyObject* arg = PyTuple_GetItem(args, i); // borrowed
+    if (convert) {
+      SETCAR(node, py_to_r(arg, true));
+    } else {
+      Py_IncRef(arg);
+      SETCAR(node, py_ref(arg, false));
+    }
+  }
+
+  if (keywords != NULL) {
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(keywords, &pos, &key, &value)) {
+      SET_TAG(node, Rf_installChar(as_r_charsxp(key)));
+      if (convert) {
+        SETCAR(node, py_to_r(value, true));
+      } else {
+        Py_IncRef(value);
+        SETCAR(node, py_ref(value, false));
+      }
+      node = CDR(node);
+    }
+  }
+
+  // evaluate the call, catching errors (and any other jumps, e.g. due to
+  // an interrupt, which would otherwise unwind through Python's stack)
+  bool busy = function->busy;
+  function->busy = true;
+  SET_VECTOR_ELT(state, FAST_R_CALL, call);
+  SET_VECTOR_ELT(state, FAST_R_CONDITION, R_NilValue);
+  Rboolean completed = R_ToplevelExec(fast_r_function_toplevel, state);
+  function->busy = busy;
+
+  // don't keep arguments alive longer than necessary
+  for (node = CDR(call); node != R_NilValue; node = CDR(node))
+    SETCAR(node, R_NilValue);
+
+  if (!cache)
+    SET_VECTOR_ELT(state, FAST_R_CALL, previous);
+
+  if (!completed) {
+    set_builtin_error("KeyboardInterrupt", NULL);
+    return NULL;
+  }
+
+  SEXP condition = VECTOR_ELT(state, FAST_R_CONDITION);
+  if (condition != R_NilValue) {
+    RObject protect(condition);
+    SET_VECTOR_ELT(state, FAST_R_CONDITION, R_NilValue);
+    fast_r_function_raise(condition);
+    return NULL;
+  }
+
+  SEXP result = VECTOR_ELT(state, FAST_R_RESULT);
+  SET_VECTOR_ELT(state, FAST_R_RESULT, R_NilValue);
+  return result;
+
+}
+
+extern "C" PyObject* call_fast_r_function(PyObject* self, PyObject* args, PyObject* keywords) {
+
+  RETICULATE_STATS_TIME(R_CALL);
+
+  FastRFunction* function =
+    (FastRFunction*) PyCapsule_GetPointer(self, fast_r_function_string);
+  if (function == NULL)
+    return NULL;
+
+  try {
+
+    SEXP value = fast_r_function_call(function, args, keywords);
+    if (value == NULL)
+      return NULL;
+
+    RObject result(value);
+    return r_to_py(result, function->convert);
+
+  } catch (PythonException& e) {
+    fast_r_function_raise(e.condition);
+  } catch (std::exception& e) {
+    set_builtin_error("RuntimeError", e.what());
+  } catch (...) {
+    set_builtin_error("RuntimeError", "(Unknown exception occurred)");
+  }
+
+  return NULL;
+
+}
+
+PyMethodDef FastRFunctionMethod = {
+  "fast_r_function", (PyCFunction) call_fast_r_function,
+  METH_VARARGS | METH_KEYWORDS, "Call an R function"
+};
+
+// [[Rcpp::export]]
+PyObjectRef py_fast_r_function(RObject f, bool convert) {
+
+  FastRFunction* function = new FastRFunction();
+  function->convert = convert;
+  function->busy = false;
+
+  List state(4);
+  state[FAST_R_FUNCTION] = f;
+  function->state = state;
+  function->token = Rcpp_precious_preserve(state);
+
+  PyObjectPtr capsule(PyCapsule_New((void*) function, fast_r_function_string, fast_r_function_free));
+  if (capsule.is_null()) {
+    Rcpp_precious_remove(function->token);
+    delete function;
+    throw PythonException(py_fetch_error());
+  }
+
+  PyObject* wrapper = PyCFunction_NewEx(&FastRFunctionMethod, capsule, NULL);
+  if (wrapper == NULL)
+    throw PythonException(py_fetch_error());
+
+  return py_ref(wrapper, convert);
+
+}
+
 struct PythonCall {
   PythonCall(PyObject* func, PyObject* data) : func(func), data(data) {
     Py_IncRef(func);
@@ -2078,45 +3864,24 @@ extern "C" PyObject* call_python_function_on_main_thread(
   PyObject* func = PyTuple_GetItem(args, 0);
   PyObject* data = PyTuple_GetItem(args, 1);
 
+  // an optional third argument gives the priority of the call
+  int priority = 0;
+  if (PyTuple_Size(args) > 2) {
+    priority = PyInt_AsLong(PyTuple_GetItem(args, 2));
+    if (priority == -1 && PyErr_Occurred())
+      return NULL;
+  }
+
   // create the call object (the func and data will be automaticlaly incref'd then
   // decrefed when the call object is destroyed)
   PythonCall* call = new PythonCall(func, data);
 
-  // Schedule calling the function. Note that we have at least one report of Py_AddPendingCall
-  // returning -1, the source code for Py_AddPendingCall is here:
-  // https://github.com/python/cpython/blob/faa135acbfcd55f79fb97f7525c8aa6f5a5b6a22/Python/ceval.c#L321-L361
-  // From this it looks like it can fail if:
-  //
-  //   (a) It can't acquire the _PyRuntime.ceval.pending.lock after 100 tries; or
-  //   (b) There are more than NPENDINGCALLS already queued
-  //
-  // As a result we need to check for failure and then sleep and retry in that case.
-  //
-  // This could in theory result in waiting "forever" but note that if we never successfully
-  // add the pending call then we will wait forever anyway as the result queue will
-  // never be signaled, i.e. see this code which waits on the call:
+  // Schedule calling the function. Calls are queued by reticulate and run
+  // together by a single pending call (see main_thread.cpp), as the table of
+  // calls used by Py_AddPendingCall is small, and scheduling fails when it's
+  // full. The wait for the call to run is done by the caller, e.g. see:
   // https://github.com/rstudio/reticulate/blob/b507f954dc08c16710f0fb39328b9770175567c0/inst/python/rpytools/generator.py#L27-L36)
-  //
-  // As a diagnostic for perverse failure to schedule the call, print a message to stderr
-  // every 60 seconds
-  //
-  const size_t wait_ms = 100;
-  size_t waited_ms = 0;
-  while(true) {
-
-    // try to schedule the pending call (exit loop on success)
-    if (Py_AddPendingCall(call_python_function, call) == 0)
-      break;
-
-    // otherwise sleep for wait_ms
-
-    tthread::this_thread::sleep_for(tthread::chrono::milliseconds(wait_ms));
-
-    // increment total wait time and print a warning every 60 seconds
-    waited_ms += wait_ms;
-    if ((waited_ms % 60000) == 0)
-      PySys_WriteStderr("Waiting to schedule call on main R interpeter thread...\n");
-  }
+  reticulate::main_thread::schedule(call_python_function, call, priority);
 
   // return none
   Py_IncRef(Py_None);
@@ -2214,7 +3979,242 @@ void trace_thread_main(void* aArg) {
 
 tthread::thread* ptrace_thread;
 void trace_thread_init(int tracems) {
-  ptrace_thread = new tthread::thread(trace_thread_main, &tracems);
+  // the interval is read by the thread for as long as it runs
+  static int interval;
+  interval = tracems;
+  ptrace_thread = new tthread::thread(trace_thread_main, &interval);
+}
+
+// A sampling profiler for mixed R / Python code (py_profile_start() and
+// py_profile_stop()). A background thread periodically schedules a sample
+// to be taken on the main thread while it runs Python code; each sample
+// records the R call stack (as seen by sys.calls()) followed by the main
+// thread's Python stack, and the Python stacks of any other threads, as
+// ';'-separated "collapsed" stacks counted in memory.
+
+namespace profiler {
+
+// the current profiling session (0 when not profiling); sampling threads
+// exit once the session they were started for has ended
+volatile int s_session = 0;
+int s_intervalMs = 10;
+volatile sig_atomic_t s_sampleRequested = 0;
+
+// counts of the collapsed stacks sampled (only accessed on the main thread)
+std::map<std::string, int> s_samples;
+
+std::string sanitize(std::string label) {
+  std::replace(label.begin(), label.end(), ';', ':');
+  std::replace(label.begin(), label.end(), '\n', ' ');
+  return label;
+}
+
+// the stack of a Python frame, from the outermost frame in
+void python_stack(PyObject* frame, std::vector<std::string>* stack) {
+
+  std::vector<std::string> frames;
+
+  PyObject* current = frame;
+  Py_IncRef(current);
+
+  while (current != NULL && !py_is_none(current)) {
+
+    PyObjectPtr code(PyObject_GetAttrString(current, "f_code"));
+    if (code.is_null())
+      break;
+
+    PyObjectPtr name(PyObject_GetAttrString(code, "co_name"));
+    PyObjectPtr filename(PyObject_GetAttrString(code, "co_filename"));
+    if (name.is_null() || filename.is_null())
+      break;
+
+    std::string file = as_std_string(filename);
+    std::string::size_type slash = file.find_last_of("/\\");
+    if (slash != std::string::npos)
+      file = file.substr(slash + 1);
+
+    frames.push_back(sanitize(as_std_string(name) + " (" + file + ")"));
+
+    PyObject* back = PyObject_GetAttrString(current, "f_back");
+    Py_DecRef(current);
+    current = back;
+
+  }
+
+  if (current != NULL)
+    Py_DecRef(current);
+
+  PyErr_Clear();
+  stack->insert(stack->end(), frames.rbegin(), frames.rend());
+
+}
+
+SEXP r_stack_calls(void*) {
+  SEXP call = PROTECT(Rf_lang1(Rf_install("sys.calls")));
+  SEXP calls = Rf_eval(call, R_BaseEnv);
+  UNPROTECT(1);
+  return calls;
+}
+
+SEXP r_stack_error(SEXP, void*) {
+  return R_NilValue;
+}
+
+// the R call stack, from the outermost call in. Samples are taken from
+// within the Python eval loop, where an R error must not longjmp, so
+// sys.calls() is evaluated by R_tryCatchError() (interrupts being
+// suspended by the caller), and the calls it adds to the stack are removed.
+void r_stack(std::vector<std::string>* stack) {
+
+  SEXP calls = PROTECT(R_tryCatchError(r_stack_calls, NULL, r_stack_error, NULL));
+
+  std::vector<std::string> names;
+  std::size_t wrapper = 0;
+  for (SEXP node = calls; node != R_NilValue; node = CDR(node)) {
+    SEXP head = CAR(CAR(node));
+    if (TYPEOF(head) == SYMSXP) {
+      std::string name = CHAR(PRINTNAME(head));
+      if (name == "tryCatch" || name == ".tryCatch")
+        wrapper = names.size();
+      names.push_back(sanitize(name));
+    } else {
+      names.push_back("(anonymous)");
+    }
+  }
+
+  // everything from the innermost tryCatch() in was added by R_tryCatchError()
+  if (!names.empty())
+    stack->insert(stack->end(), names.begin(), names.begin() + wrapper);
+
+  UNPROTECT(1);
+
+}
+
+std::string collapse(const std::vector<std::string>& stack) {
+  std::string collapsed;
+  for (std::size_t i = 0; i < stack.size(); i++) {
+    if (i > 0)
+      collapsed += ';';
+    collapsed += stack[i];
+  }
+  return collapsed;
+}
+
+int sample(void*) {
+
+  s_sampleRequested = 0;
+  if (s_session == 0)
+    return 0;
+
+  PyObject *error_type, *error_value, *error_traceback;
+  PyErr_Fetch(&error_type, &error_value, &error_traceback);
+
+  // the stacks of all Python threads, keyed by thread id
+  PyObjectPtr sys(py_import("sys"));
+  PyObjectPtr frames;
+  if (!sys.is_null())
+    frames.assign(PyObject_CallMethod(sys, "_current_frames", NULL));
+
+  PyObjectPtr threading(py_import("threading"));
+  long main_id = -1;
+  if (!threading.is_null()) {
+    PyObjectPtr main(PyObject_CallMethod(threading, "main_thread", NULL));
+    PyObjectPtr ident;
+    if (!main.is_null())
+      ident.assign(PyObject_GetAttrString(main, "ident"));
+    if (!ident.is_null())
+      main_id = PyLong_AsLong(ident);
+  }
+
+  if (!frames.is_null()) {
+
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(frames, &pos, &key, &value)) {
+
+      std::vector<std::string> stack;
+      long id = PyLong_AsLong(key);
+      if (id == main_id) {
+        reticulate::signals::InterruptsSuspendedScope scope;
+        r_stack(&stack);
+      } else {
+        std::ostringstream label;
+        label << "[thread " << id << "]";
+        stack.push_back(label.str());
+      }
+
+      python_stack(value, &stack);
+      s_samples[collapse(stack)]++;
+
+    }
+
+  }
+
+  PyErr_Clear();
+  PyErr_Restore(error_type, error_value, error_traceback);
+  return 0;
+
+}
+
+void sampler(void* data) {
+
+  int session = (int)(intptr_t) data;
+  while (s_session == session) {
+
+    tthread::this_thread::sleep_for(tthread::chrono::milliseconds(s_intervalMs));
+
+    // (if the previous sample hasn't been taken yet, Python isn't running)
+    if (s_session == session && s_sampleRequested == 0) {
+      s_sampleRequested = 1;
+      Py_AddPendingCall(sample, NULL);
+    }
+
+  }
+
+}
+
+} // namespace profiler
+
+// [[Rcpp::export]]
+void py_profile_start_impl(int interval) {
+
+  if (profiler::s_session != 0)
+    stop("Profiling is already in progress");
+
+  static int sessions = 0;
+  profiler::s_samples.clear();
+  profiler::s_intervalMs = std::max(interval, 1);
+  profiler::s_sampleRequested = 0;
+  profiler::s_session = ++sessions;
+
+  tthread::thread t(profiler::sampler, (void*)(intptr_t) profiler::s_session);
+  t.detach();
+
+}
+
+// [[Rcpp::export]]
+IntegerVector py_profile_stop_impl() {
+
+  if (profiler::s_session == 0)
+    stop("Profiling is not in progress");
+
+  profiler::s_session = 0;
+
+  std::size_t n = profiler::s_samples.size();
+  IntegerVector counts(n);
+  CharacterVector stacks(n);
+
+  std::size_t i = 0;
+  std::map<std::string, int>::const_iterator it;
+  for (it = profiler::s_samples.begin(); it != profiler::s_samples.end(); ++it, ++i) {
+    stacks[i] = it->first;
+    counts[i] = it->second;
+  }
+
+  profiler::s_samples.clear();
+  counts.names() = stacks;
+  return counts;
+
 }
 
 namespace {
@@ -2336,7 +4336,8 @@ void py_initialize(const std::string& python,
                    const std::string& virtualenv_activate,
                    bool python3,
                    bool interactive,
-                   const std::string& numpy_load_error) {
+                   const std::string& numpy_load_error,
+                   bool defer_numpy) {
 
   // set python3 and interactive flags
   s_isPython3 = python3;
@@ -2405,7 +4406,9 @@ void py_initialize(const std::string& python,
   }
 
   s_main_thread = tthread::this_thread::get_id();
+
   s_is_python_initialized = true;
+  py_decref_pending_register_exit_hook();
   GILScope scope;
 
   // initialize type objects
@@ -2415,26 +4418,36 @@ void py_initialize(const std::string& python,
   if (!virtualenv_activate.empty())
     py_activate_virtualenv(virtualenv_activate);
 
-  // resovlve numpy
-  if (numpy_load_error.empty())
-    import_numpy_api(is_python3(), &s_numpy_load_error);
+  // resolve numpy, now or (when deferred) on first use
+  s_numpy_load_error = numpy_load_error;
+  if (!numpy_load_error.empty())
+    s_numpy_state = NUMPY_UNAVAILABLE;
+  else if (defer_numpy)
+    s_numpy_state = NUMPY_DEFERRED;
+  else if (import_numpy_api(is_python3(), &s_numpy_load_error))
+    s_numpy_state = NUMPY_LOADED;
   else
-    s_numpy_load_error = numpy_load_error;
+    s_numpy_state = NUMPY_UNAVAILABLE;
 
   // initialize trace
-  Function sysGetEnv("Sys.getenv");
-  std::string tracems_env = as<std::string>(sysGetEnv("RETICULATE_DUMP_STACK_TRACE", 0));
-  int tracems = ::atoi(tracems_env.c_str());
+  const char* tracems_env = ::getenv("RETICULATE_DUMP_STACK_TRACE");
+  int tracems = tracems_env == NULL ? 0 : ::atoi(tracems_env);
   if (tracems > 0)
     trace_thread_init(tracems);
 
   // poll for events while executing python code
-  reticulate::event_loop::initialize();
+  int interval = 0;
+  SEXP intervalSEXP = Rf_GetOption1(Rf_install("reticulate.poll_interval"));
+  if (Rf_isNumeric(intervalSEXP) && Rf_length(intervalSEXP) == 1)
+    interval = Rf_asInteger(intervalSEXP);
+  reticulate::event_loop::initialize(interval);
 
 }
 
 // [[Rcpp::export]]
 void py_finalize() {
+  py_decref_pending();
+
   // We shouldn't call PyFinalize() if R is embedded in Python. https://github.com/rpy2/rpy2/issues/872
   // if(!s_is_python_initialized && !s_was_python_initialized_by_reticulate)
   //   return;
@@ -2444,6 +4457,75 @@ void py_finalize() {
   // s_was_python_initialized_by_reticulate = false;
 }
 
+// [[Rcpp::export]]
+SEXP py_event_loop_stats_impl() {
+  reticulate::event_loop::Stats stats = reticulate::event_loop::stats();
+  List result;
+  result["wakeups"] = stats.wakeups;
+  result["parks"] = stats.parks;
+  result["polls"] = stats.polls;
+  result["flushes"] = stats.flushes;
+  return result;
+}
+
+// [[Rcpp::export]]
+SEXP py_conversion_stats_impl() {
+
+  using namespace reticulate::stats;
+
+  const char* events[EVENT_COUNT] = {
+    "py_to_r", "r_to_py", "r_to_py_dispatch", "py_ref",
+    "class_lookup", "py_call", "r_call", "py_fetch_error"
+  };
+
+  NumericVector calls(EVENT_COUNT), seconds(EVENT_COUNT);
+  CharacterVector names(EVENT_COUNT);
+  for (int i = 0; i < EVENT_COUNT; i++) {
+    names[i] = events[i];
+    calls[i] = s_counters.calls[i];
+    seconds[i] = s_counters.seconds[i];
+  }
+  calls.names() = names;
+  seconds.names() = names;
+
+  NumericVector py_types(s_counters.py_types.size());
+  CharacterVector py_type_names(s_counters.py_types.size());
+  std::size_t i = 0;
+  std::map<std::string, double>::const_iterator it;
+  for (it = s_counters.py_types.begin(); it != s_counters.py_types.end(); ++it, ++i) {
+    py_type_names[i] = it->first;
+    py_types[i] = it->second;
+  }
+  py_types.names() = py_type_names;
+
+  std::vector<double> r_types;
+  std::vector<std::string> r_type_names;
+  for (int type = 0; type < 32; type++) {
+    if (s_counters.r_types[type] == 0)
+      continue;
+    r_type_names.push_back(Rf_type2char((SEXPTYPE) type));
+    r_types.push_back(s_counters.r_types[type]);
+  }
+  NumericVector r_types_vec(r_types.begin(), r_types.end());
+  r_types_vec.names() = CharacterVector(r_type_names.begin(), r_type_names.end());
+
+  List result;
+  result["enabled"] = s_enabled;
+  result["calls"] = calls;
+  result["seconds"] = seconds;
+  result["elements"] = s_counters.elements;
+  result["bytes"] = s_counters.bytes;
+  result["py_types"] = py_types;
+  result["r_types"] = r_types_vec;
+  return result;
+
+}
+
+// [[Rcpp::export]]
+void py_conversion_stats_reset_impl(bool enable) {
+  reticulate::stats::reset(enable);
+}
+
 // [[Rcpp::export]]
 bool py_is_none(PyObjectRef x) {
   return py_is_none(x.get());
@@ -2545,29 +4627,128 @@ std::vector<std::string> py_list_attributes_impl(PyObjectRef x) {
     attributes.push_back(as_std_string(item));
   }
 
-  return attributes;
-}
+  return attributes;
+}
+
+// [[Rcpp::export]]
+bool py_has_attr_impl(PyObjectRef x, const std::string& name) {
+  if (py_is_null_xptr(x))
+    return false;
+  return PyObject_HasAttrString(x, name.c_str());
+}
+
+class PyErrorScopeGuard {
+private:
+  PyObject *er_type, *er_value, *er_traceback;
+
+public:
+  PyErrorScopeGuard() {
+    PyErr_Fetch(&er_type, &er_value, &er_traceback);
+  }
+
+  ~PyErrorScopeGuard() {
+    PyErr_Restore(er_type, er_value, er_traceback);
+  }
+};
+
+// the object bound to 'name' in a module's dict (a borrowed reference),
+// or NULL if it isn't bound there
+PyObject* py_module_dict_item(PyObject* module, const std::string& name) {
+  PyObject* dict = PyModule_GetDict(module);
+  if (dict == NULL) {
+    PyErr_Clear();
+    return NULL;
+  }
+  PyAttrCache::iterator it = s_attr_cache.find(module);
+  if (it != s_attr_cache.end()) {
+    PyAttrCacheModule::iterator entry = it->second.find(name);
+    if (entry != it->second.end())
+      return PyDict_GetItem(dict, entry->second.name);
+  }
+  return PyDict_GetItemString(dict, name.c_str());
+}
+
+SEXP py_attr_cache_get(PyObject* module, const std::string& name, bool convert) {
+
+  PyAttrCache::iterator it = s_attr_cache.find(module);
+  if (it == s_attr_cache.end())
+    return R_NilValue;
+
+  PyAttrCacheModule::iterator entry = it->second.find(name);
+  if (entry == it->second.end())
+    return R_NilValue;
+
+  // the module may since have been replaced by another at the same
+  // address, its type modified, or the member rebound
+  const PyAttrCacheEntry& cached = entry->second;
+  PyObject* moduleType = (PyObject*) Py_TYPE(module);
+  if (moduleType != cached.moduleType ||
+      py_type_version_tag(moduleType) != cached.moduleVersion)
+  {
+    return R_NilValue;
+  }
+
+  PyObject* dict = PyModule_GetDict(module);
+  PyObject* value = dict == NULL ? NULL : PyDict_GetItem(dict, cached.name);
+  if (value == NULL ||
+      (PyObject*) Py_TYPE(value) != cached.type ||
+      py_type_version_tag(cached.type) != cached.version)
+  {
+    return R_NilValue;
+  }
+
+  Py_IncRef(value);
+  PyObjectRef ref(value, convert);
+  ref.attr("class") = VECTOR_ELT(s_attr_cache_classes, cached.classes);
+  return ref;
 
-// [[Rcpp::export]]
-bool py_has_attr_impl(PyObjectRef x, const std::string& name) {
-  if (py_is_null_xptr(x))
-    return false;
-  return PyObject_HasAttrString(x, name.c_str());
 }
 
-class PyErrorScopeGuard {
-private:
-  PyObject *er_type, *er_value, *er_traceback;
+void py_attr_cache_put(PyObject* module, const std::string& name,
+                       PyObject* value, SEXP ref)
+{
+  if (!PyModule_Check(module))
+    return;
 
-public:
-  PyErrorScopeGuard() {
-    PyErr_Fetch(&er_type, &er_value, &er_traceback);
+  // the reference's classes were computed from the object's __class__,
+  // which must be its type for them to be reused for other objects
+  PyObject* moduleType = (PyObject*) Py_TYPE(module);
+  PyObject* type = (PyObject*) Py_TYPE(value);
+  unsigned int moduleVersion = py_type_version_tag(moduleType);
+  unsigned int version = py_type_version_tag(type);
+  if (moduleVersion == 0 || version == 0)
+    return;
+  if (!PyModule_CheckExact(value) && !py_type_has_plain_attributes(value))
+    return;
+
+  if (s_attr_cache_size >= s_attr_cache_max_size)
+    py_clear_attr_cache();
+
+  if (s_attr_cache_classes == R_NilValue) {
+    s_attr_cache_classes = Rf_allocVector(VECSXP, s_attr_cache_max_size);
+    R_PreserveObject(s_attr_cache_classes);
   }
 
-  ~PyErrorScopeGuard() {
-    PyErr_Restore(er_type, er_value, er_traceback);
+  PyAttrCacheModule& entries = s_attr_cache[module];
+  PyAttrCacheModule::iterator entry = entries.find(name);
+  if (entry == entries.end()) {
+    // (the string caches its hash once first used as a dict key)
+    PyAttrCacheEntry created;
+    created.name = as_python_str(name);
+    created.classes = s_attr_cache_size++;
+    entry = entries.insert(std::make_pair(name, created)).first;
   }
-};
+
+  PyAttrCacheEntry& cached = entry->second;
+  cached.moduleType = moduleType;
+  cached.moduleVersion = moduleVersion;
+  cached.type = type;
+  cached.version = version;
+  SEXP classes = Rf_getAttrib(ref, R_ClassSymbol);
+  MARK_NOT_MUTABLE(classes);
+  SET_VECTOR_ELT(s_attr_cache_classes, cached.classes, classes);
+
+}
 
 // [[Rcpp::export]]
 PyObjectRef py_get_attr_impl(PyObjectRef x,
@@ -2575,6 +4756,19 @@ PyObjectRef py_get_attr_impl(PyObjectRef x,
                              bool silent = false)
 {
 
+  // module members are cached, as long as they remain bound to the same
+  // object (members found elsewhere, e.g. through a module __getattr__,
+  // are not)
+  bool convert = x.convert();
+  PyObject* module = x.get();
+  PyObject* member = NULL;
+  if (PyModule_Check(module)) {
+    SEXP cached = py_attr_cache_get(module, key, convert);
+    if (cached != R_NilValue)
+      return PyObjectRef(cached);
+    member = py_module_dict_item(module, key);
+  }
+
   PyObject *attr;
 
   if (silent) {
@@ -2592,7 +4786,11 @@ PyObjectRef py_get_attr_impl(PyObjectRef x,
 
   }
 
-  return py_ref(attr, x.convert());
+  PyObjectRef ref = py_ref(attr, convert);
+  if (member != NULL && member == attr)
+    py_attr_cache_put(module, key, attr, ref);
+
+  return ref;
 }
 
 // [[Rcpp::export]]
@@ -2648,130 +4846,558 @@ void py_set_item_impl(PyObjectRef x,
   PyObjectPtr py_key(r_to_py(key, x.convert()));
   PyObjectPtr py_val(r_to_py(val, x.convert()));
 
-  int res = PyObject_SetItem(x, py_key, py_val);
-  if (res != 0)
-    throw PythonException(py_fetch_error());
+  int res = PyObject_SetItem(x, py_key, py_val);
+  if (res != 0)
+    throw PythonException(py_fetch_error());
+}
+
+
+// [[Rcpp::export]]
+IntegerVector py_get_attr_types_impl(
+    PyObjectRef x,
+    const std::vector<std::string>& attrs,
+    bool resolve_properties)
+{
+  const int UNKNOWN     =  0;
+  const int VECTOR      =  1;
+  const int ARRAY       =  2;
+  const int LIST        =  4;
+  const int ENVIRONMENT =  5;
+  const int FUNCTION    =  6;
+  PyErrorScopeGuard _g;
+  PyObjectPtr type( PyObject_GetAttrString(x, "__class__") );
+
+  // members of plain modules are read from the module's dict, which
+  // needn't be checked for properties first
+  bool module = PyModule_CheckExact(x.get());
+
+  std::size_t n = attrs.size();
+  IntegerVector types = no_init(n);
+  for (std::size_t i = 0; i < n; i++) {
+    const std::string& name = attrs[i];
+
+    PyObject* member = module ? py_module_dict_item(x, name) : NULL;
+
+    // check if this is a property; if so, avoid resolving it unless
+    // requested as this could imply running arbitrary Python code
+    if (!resolve_properties && !module) {
+      PyObjectPtr attr(PyObject_GetAttrString(type, name.c_str()));
+      if (attr.is_null())
+        PyErr_Clear();
+      else if (PyObject_TypeCheck(attr, PyProperty_Type)) {
+        types[i] = UNKNOWN;
+        continue;
+      }
+    }
+
+    if (member != NULL)
+      Py_IncRef(member);
+    PyObjectPtr attr(member != NULL ? member : PyObject_GetAttrString(x, name.c_str()));
+
+    if(attr.is_null()) {
+      PyErr_Clear();
+      types[i] = UNKNOWN;
+    }
+    else if (attr.get() == Py_None)
+      types[i] = UNKNOWN;
+    else if (PyType_Check(attr))
+      types[i] = UNKNOWN;
+    else if (PyCallable_Check(attr))
+      types[i] = FUNCTION;
+    else if (PyList_Check(attr)  ||
+             PyTuple_Check(attr) ||
+             PyDict_Check(attr))
+      types[i] = LIST;
+    else if (isPyArray(attr))
+      types[i] = ARRAY;
+    else if (PyBool_Check(attr)   ||
+             PyInt_Check(attr)    ||
+             PyLong_Check(attr)   ||
+             PyFloat_Check(attr)  ||
+             is_python_str(attr))
+      types[i] = VECTOR;
+    else if (PyObject_IsInstance(attr, (PyObject*)PyModule_Type))
+      types[i] = ENVIRONMENT;
+    else
+      // presume that other types are objects
+      types[i] = LIST;
+  }
+
+  return types;
+}
+
+
+// [[Rcpp::export]]
+SEXP py_ref_to_r_with_convert(PyObjectRef x, bool convert) {
+  return py_to_r(x, convert);
+}
+
+// [[Rcpp::export]]
+SEXP py_ref_to_r(PyObjectRef x) {
+  return py_ref_to_r_with_convert(x, x.convert());
+}
+
+
+
+
+// convert the unnamed arguments of a call to a Python tuple
+PyObject* py_call_args(List args, bool convert) {
+
+  PyObjectPtr pyArgs(PyTuple_New(args.length()));
+  for (R_xlen_t i = 0; i<args.size(); i++) {
+    PyObject* arg = r_to_py(args.at(i), convert);
+    // NOTE: reference to arg is "stolen" by the tuple
+    int res = PyTuple_SetItem(pyArgs, i, arg);
+    if (res != 0)
+      throw PythonException(py_fetch_error());
+  }
+
+  return pyArgs.detach();
+
+}
+
+// convert the named arguments of a call to a Python dict (or NULL, when
+// there are none)
+PyObject* py_call_keywords(List keywords, bool convert) {
+
+  if (keywords.length() == 0)
+    return NULL;
+
+  PyObjectPtr pyKeywords(PyDict_New());
+  CharacterVector names = keywords.names();
+  SEXP namesSEXP = names;
+  for (R_xlen_t i = 0; i<keywords.length(); i++) {
+    const char* name = Rf_translateChar(STRING_ELT(namesSEXP, i));
+    PyObjectPtr arg(r_to_py(keywords.at(i), convert));
+    int res = PyDict_SetItemString(pyKeywords, name, arg);
+    if (res != 0)
+      throw PythonException(py_fetch_error());
+  }
+
+  return pyKeywords.detach();
+
+}
+
+// [[Rcpp::export]]
+SEXP py_call_impl(PyObjectRef x, List args = R_NilValue, List keywords = R_NilValue) {
+
+  RETICULATE_STATS_TIME(PY_CALL);
+
+  PyObjectPtr pyArgs(py_call_args(args, x.convert()));
+  PyObjectPtr pyKeywords(py_call_keywords(keywords, x.convert()));
+
+  // call the function
+  PyObjectPtr res(PyObject_Call(x, pyArgs, pyKeywords));
+
+  // check for error
+  if (res.is_null())
+    throw PythonException(py_fetch_error(true));
+
+  // return
+  return py_ref(res.detach(), x.convert());
+}
+
+// convert element i of an R vector or list to Python, as r_to_py() would
+// convert the corresponding length one vector
+PyObject* r_to_py_element(SEXP x, R_xlen_t i, bool convert) {
+  switch (TYPEOF(x)) {
+  case LGLSXP:  return PyBool_FromLong(LOGICAL(x)[i]);
+  case INTSXP:  return PyInt_FromLong(INTEGER(x)[i]);
+  case REALSXP: return PyFloat_FromDouble(REAL(x)[i]);
+  case CPLXSXP: return PyComplex_FromDoubles(COMPLEX(x)[i].r, COMPLEX(x)[i].i);
+  case STRSXP:  return as_python_str(STRING_ELT(x, i));
+  case VECSXP:  return r_to_py(VECTOR_ELT(x, i), convert);
+  default:
+    stop("Unable to iterate over an R object of type '%s'",
+         Rf_type2char(TYPEOF(x)));
+  }
+}
+
+// a reusable buffer of owned references to Python objects
+class PyObjectBuffer {
+public:
+  explicit PyObjectBuffer(std::size_t n) : items_(n, NULL) {}
+  ~PyObjectBuffer() { clear(); }
+
+  PyObject** data() { return &items_[0]; }
+  PyObject*& operator[](std::size_t i) { return items_[i]; }
+
+  void clear() {
+    for (std::size_t i = 0; i < items_.size(); i++) {
+      if (items_[i] != NULL) {
+        Py_DecRef(items_[i]);
+        items_[i] = NULL;
+      }
+    }
+  }
+
+private:
+  std::vector<PyObject*> items_;
+};
+
+// collects the results of repeated calls as py_to_r() would convert a
+// list of those results: while the results are scalars of a single type,
+// they're written straight into an atomic vector, switching to a list
+// (of converted results) otherwise
+class PyResultCollector {
+public:
+  PyResultCollector(R_xlen_t n, bool convert)
+    : n_(n), convert_(convert), type_(NILSXP) {}
+
+  void set(R_xlen_t i, PyObject* value) {
+
+    if (!convert_) {
+      ensure(VECSXP);
+      Py_IncRef(value);
+      SET_VECTOR_ELT(result_, i, py_ref(value, false));
+      return;
+    }
+
+    int type = r_scalar_type(value);
+    ensure(type == NILSXP ? VECSXP : type);
+
+    if (type != type_) {
+      if (type_ != VECSXP) {
+        result_ = Rf_coerceVector(result_, VECSXP);
+        type_ = VECSXP;
+      }
+      SET_VECTOR_ELT(result_, i, py_to_r(value, true));
+      return;
+    }
+
+    switch (type_) {
+    case LGLSXP:  LOGICAL(result_)[i] = value == Py_True; break;
+    case INTSXP:  INTEGER(result_)[i] = PyInt_AsLong(value); break;
+    case REALSXP: REAL(result_)[i] = PyFloat_AsDouble(value); break;
+    case CPLXSXP: {
+      Rcomplex cplx;
+      cplx.r = PyComplex_RealAsDouble(value);
+      cplx.i = PyComplex_ImagAsDouble(value);
+      COMPLEX(result_)[i] = cplx;
+      break;
+    }
+    case STRSXP:  SET_STRING_ELT(result_, i, as_r_charsxp(value)); break;
+    }
+
+  }
+
+  SEXP result() {
+    ensure(VECSXP);
+    return result_;
+  }
+
+private:
+
+  // the type of the result is chosen by its first element
+  void ensure(int type) {
+    if (type_ != NILSXP)
+      return;
+    type_ = type;
+    result_ = Rf_allocVector(type, n_);
+  }
+
+  R_xlen_t n_;
+  bool convert_;
+  int type_;
+  RObject result_;
+};
+
+// call a Python callable once for each (recycled) element of the supplied
+// arguments, reusing the argument buffer from call to call
+// [[Rcpp::export]]
+SEXP py_call_map_impl(PyObjectRef f, List args = R_NilValue, List keywords = R_NilValue) {
+
+  RETICULATE_STATS_TIME(PY_CALL);
+
+  bool convert = f.convert();
+  R_xlen_t nargs = args.size();
+  R_xlen_t nkeywords = keywords.size();
+
+  // (as there would be nothing to take the number of calls from)
+  if (nargs + nkeywords == 0)
+    stop("py_call_map() requires at least one argument to map over");
+
+  std::vector<SEXP> sources;
+  for (R_xlen_t i = 0; i < nargs; i++)
+    sources.push_back(args[i]);
+  for (R_xlen_t i = 0; i < nkeywords; i++)
+    sources.push_back(keywords[i]);
+
+  // arguments are recycled to the length of the longest one
+  R_xlen_t n = 0;
+  std::vector<R_xlen_t> lengths;
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    lengths.push_back(Rf_xlength(sources[i]));
+    n = std::max(n, lengths[i]);
+  }
+
+  for (std::size_t i = 0; i < lengths.size(); i++)
+    if (lengths[i] == 0)
+      n = 0;
+
+  PyObjectPtr kwnames;
+  if (nkeywords > 0) {
+    kwnames.assign(PyTuple_New(nkeywords));
+    CharacterVector names = keywords.names();
+    for (R_xlen_t i = 0; i < nkeywords; i++)
+      PyTuple_SetItem(kwnames, i, as_python_name(STRING_ELT(names, i)));
+  }
+
+  // the first slot is left free, so that vectorcall can use it
+  std::size_t nsources = sources.size();
+  PyObjectBuffer buffer(nsources + 1);
+
+  PyResultCollector collector(n, convert);
+  for (R_xlen_t i = 0; i < n; i++) {
+
+    for (std::size_t j = 0; j < nsources; j++)
+      buffer[j + 1] = r_to_py_element(sources[j], i % lengths[j], convert);
+
+    PyObject* result;
+    if (PyObject_Vectorcall != NULL) {
+      size_t nargsf = nargs | PY_VECTORCALL_ARGUMENTS_OFFSET;
+      result = PyObject_Vectorcall(f, buffer.data() + 1, nargsf, kwnames);
+    } else {
+
+      PyObjectPtr pyArgs(PyTuple_New(nargs));
+      for (R_xlen_t j = 0; j < nargs; j++) {
+        Py_IncRef(buffer[j + 1]);
+        PyTuple_SetItem(pyArgs, j, buffer[j + 1]);
+      }
+
+      PyObjectPtr pyKeywords;
+      if (nkeywords > 0) {
+        pyKeywords.assign(PyDict_New());
+        for (R_xlen_t j = 0; j < nkeywords; j++) {
+          PyObject* name = PyTuple_GetItem(kwnames, j);
+          if (PyDict_SetItem(pyKeywords, name, buffer[nargs + j + 1]) != 0)
+            throw PythonException(py_fetch_error());
+        }
+      }
+
+      result = PyObject_Call(f, pyArgs, pyKeywords);
+
+    }
+
+    buffer.clear();
+
+    if (result == NULL)
+      throw PythonException(py_fetch_error(true));
+
+    PyObjectPtr resultPtr(result);
+    collector.set(i, resultPtr);
+
+    // allow long batches to be interrupted
+    if ((i + 1) % 1024 == 0)
+      Rcpp::checkUserInterrupt();
+
+  }
+
+  return collector.result();
+
+}
+
+// the state of a call made on a background thread by py_call_async(),
+// shared by that thread and the R handle for the call
+struct PyAsyncCall {
+
+  tthread::mutex mutex;
+  int references;
+  bool done;
+  bool convert;
+
+  PyObject* callable;
+  PyObject* args;
+  PyObject* kwargs;
+
+  // the result of the call, or the exception it raised
+  PyObject* result;
+  PyObject* type;
+  PyObject* value;
+  PyObject* traceback;
+
+};
+
+// drop a reference to an async call. The last reference releases the
+// Python objects held by the call: directly when the GIL is held, and
+// otherwise (from R's garbage collector) by queueing them to be released
+// when R next calls into Python.
+void py_async_call_release(PyAsyncCall* call, bool gil_held) {
+
+  bool last;
+  {
+    tthread::lock_guard<tthread::mutex> guard(call->mutex);
+    last = --call->references == 0;
+  }
+
+  if (!last)
+    return;
+
+  PyObject* objects[] = {
+    call->callable, call->args, call->kwargs,
+    call->result, call->type, call->value, call->traceback
+  };
+
+  for (std::size_t i = 0; i < sizeof(objects) / sizeof(PyObject*); i++) {
+    if (objects[i] == NULL)
+      continue;
+    if (gil_held)
+      Py_DecRef(objects[i]);
+    else
+      py_decref_later(objects[i]);
+  }
+
+  delete call;
+
+}
+
+bool py_async_call_is_done(PyAsyncCall* call) {
+  tthread::lock_guard<tthread::mutex> guard(call->mutex);
+  return call->done;
+}
+
+void py_async_call_worker(void* data) {
+
+  PyAsyncCall* call = (PyAsyncCall*) data;
+  PyGILState_STATE state = PyGILState_Ensure();
+
+  call->result = PyObject_Call(call->callable, call->args, call->kwargs);
+  if (call->result == NULL)
+    PyErr_Fetch(&call->type, &call->value, &call->traceback);
+
+  {
+    tthread::lock_guard<tthread::mutex> guard(call->mutex);
+    call->done = true;
+  }
+
+  py_async_call_release(call, true);
+  PyGILState_Release(state);
+
 }
 
+void py_async_call_finalize(SEXP ptr) {
 
-// [[Rcpp::export]]
-IntegerVector py_get_attr_types_impl(
-    PyObjectRef x,
-    const std::vector<std::string>& attrs,
-    bool resolve_properties)
-{
-  const int UNKNOWN     =  0;
-  const int VECTOR      =  1;
-  const int ARRAY       =  2;
-  const int LIST        =  4;
-  const int ENVIRONMENT =  5;
-  const int FUNCTION    =  6;
-  PyErrorScopeGuard _g;
-  PyObjectPtr type( PyObject_GetAttrString(x, "__class__") );
+  PyAsyncCall* call = (PyAsyncCall*) R_ExternalPtrAddr(ptr);
+  if (call == NULL)
+    return;
 
-  std::size_t n = attrs.size();
-  IntegerVector types = no_init(n);
-  for (std::size_t i = 0; i < n; i++) {
-    const std::string& name = attrs[i];
+  py_async_call_release(call, false);
+  R_ClearExternalPtr(ptr);
 
-    // check if this is a property; if so, avoid resolving it unless
-    // requested as this could imply running arbitrary Python code
-    if (!resolve_properties) {
-      PyObjectPtr attr(PyObject_GetAttrString(type, name.c_str()));
-      if (attr.is_null())
-        PyErr_Clear();
-      else if (PyObject_TypeCheck(attr, PyProperty_Type)) {
-        types[i] = UNKNOWN;
-        continue;
-      }
-    }
+}
 
-    PyObjectPtr attr(PyObject_GetAttrString(x, name.c_str()));
+PyAsyncCall* py_async_call_get(SEXP ptr) {
 
-    if(attr.is_null()) {
-      PyErr_Clear();
-      types[i] = UNKNOWN;
-    }
-    else if (attr.get() == Py_None)
-      types[i] = UNKNOWN;
-    else if (PyType_Check(attr))
-      types[i] = UNKNOWN;
-    else if (PyCallable_Check(attr))
-      types[i] = FUNCTION;
-    else if (PyList_Check(attr)  ||
-             PyTuple_Check(attr) ||
-             PyDict_Check(attr))
-      types[i] = LIST;
-    else if (isPyArray(attr))
-      types[i] = ARRAY;
-    else if (PyBool_Check(attr)   ||
-             PyInt_Check(attr)    ||
-             PyLong_Check(attr)   ||
-             PyFloat_Check(attr)  ||
-             is_python_str(attr))
-      types[i] = VECTOR;
-    else if (PyObject_IsInstance(attr, (PyObject*)PyModule_Type))
-      types[i] = ENVIRONMENT;
-    else
-      // presume that other types are objects
-      types[i] = LIST;
-  }
+  PyAsyncCall* call = NULL;
+  if (TYPEOF(ptr) == EXTPTRSXP)
+    call = (PyAsyncCall*) R_ExternalPtrAddr(ptr);
 
-  return types;
-}
+  if (call == NULL)
+    stop("Invalid asynchronous Python call");
 
+  return call;
 
-// [[Rcpp::export]]
-SEXP py_ref_to_r_with_convert(PyObjectRef x, bool convert) {
-  return py_to_r(x, convert);
 }
 
+// start calling a Python callable on a new background thread, returning
+// an external pointer to the state of the call
 // [[Rcpp::export]]
-SEXP py_ref_to_r(PyObjectRef x) {
-  return py_ref_to_r_with_convert(x, x.convert());
+SEXP py_call_async_impl(PyObjectRef f, List args = R_NilValue, List keywords = R_NilValue) {
+
+  PyObjectPtr pyArgs(py_call_args(args, f.convert()));
+  PyObjectPtr pyKeywords(py_call_keywords(keywords, f.convert()));
+
+  // Python < 3.7 only creates the GIL once asked to
+  if (PyEval_InitThreads != NULL)
+    PyEval_InitThreads();
+
+  PyAsyncCall* call = new PyAsyncCall();
+  call->references = 2;
+  call->done = false;
+  call->convert = f.convert();
+
+  Py_IncRef(f.get());
+  call->callable = f.get();
+  call->args = pyArgs.detach();
+  call->kwargs = pyKeywords.detach();
+
+  call->result = NULL;
+  call->type = call->value = call->traceback = NULL;
+
+  SEXP ptr = PROTECT(R_MakeExternalPtr((void*) call, R_NilValue, R_NilValue));
+  R_RegisterCFinalizer(ptr, py_async_call_finalize);
+
+  tthread::thread worker(py_async_call_worker, (void*) call);
+  worker.detach();
+
+  UNPROTECT(1);
+  return ptr;
+
 }
 
+// wait for up to `seconds` for an async call to complete, releasing the GIL
+// held by the main thread meanwhile so that the call can run, and return
+// whether it has completed. The main thread otherwise keeps the GIL while R
+// runs, and gives it up only here, and while running Python code. The GIL
+// is retaken every 100 ms to check for interrupts; with no time to wait, it
+// is released just long enough for a thread waiting for it to take it.
+bool py_async_call_wait(PyAsyncCall* call, double seconds) {
 
+  if (py_async_call_is_done(call))
+    return true;
 
+  // in milliseconds; waits of more than a day are broken up by the caller
+  long remaining = seconds > 0 ? (long) (std::min(seconds, 86400.0) * 1000) : 0;
 
-// [[Rcpp::export]]
-SEXP py_call_impl(PyObjectRef x, List args = R_NilValue, List keywords = R_NilValue) {
+  do {
 
-  // unnamed arguments
-  PyObjectPtr pyArgs(PyTuple_New(args.length()));
-  if (args.length() > 0) {
-    for (R_xlen_t i = 0; i<args.size(); i++) {
-      PyObject* arg = r_to_py(args.at(i), x.convert());
-      // NOTE: reference to arg is "stolen" by the tuple
-      int res = PyTuple_SetItem(pyArgs, i, arg);
-      if (res != 0)
-        throw PythonException(py_fetch_error());
-    }
-  }
+    long slice = std::min(remaining, 100L);
+    PyThreadState* state = PyEval_SaveThread();
+    for (long i = 0; i < slice && !py_async_call_is_done(call); i++)
+      tthread::this_thread::sleep_for(tthread::chrono::milliseconds(1));
+    PyEval_RestoreThread(state);
 
-  // named arguments
-  PyObjectPtr pyKeywords(PyDict_New());
-  if (keywords.length() > 0) {
-    CharacterVector names = keywords.names();
-    SEXP namesSEXP = names;
-    for (R_xlen_t i = 0; i<keywords.length(); i++) {
-      const char* name = Rf_translateChar(STRING_ELT(namesSEXP, i));
-      PyObjectPtr arg(r_to_py(keywords.at(i), x.convert()));
-      int res = PyDict_SetItemString(pyKeywords, name, arg);
-      if (res != 0)
-        throw PythonException(py_fetch_error());
-    }
-  }
+    if (py_async_call_is_done(call))
+      return true;
 
-  // call the function
-  PyObjectPtr res(PyObject_Call(x, pyArgs, pyKeywords));
+    Rcpp::checkUserInterrupt();
+    remaining -= slice;
 
-  // check for error
-  if (res.is_null())
+  } while (remaining > 0);
+
+  return false;
+
+}
+
+// check whether an async call has completed, waiting for up to `timeout`
+// seconds for it to do so
+// [[Rcpp::export]]
+bool py_call_async_done(SEXP ptr, double timeout = 0) {
+  return py_async_call_wait(py_async_call_get(ptr), timeout);
+}
+
+// wait for an async call to complete, releasing the GIL meanwhile so that
+// the call can proceed, and return its result (or raise its exception)
+// [[Rcpp::export]]
+SEXP py_call_async_value(SEXP ptr) {
+
+  PyAsyncCall* call = py_async_call_get(ptr);
+  while (!py_async_call_wait(call, 86400))
+    ;
+
+  if (call->result == NULL) {
+    Py_IncRef(call->type);
+    if (call->value != NULL)
+      Py_IncRef(call->value);
+    if (call->traceback != NULL)
+      Py_IncRef(call->traceback);
+    PyErr_Restore(call->type, call->value, call->traceback);
     throw PythonException(py_fetch_error(true));
+  }
+
+  Py_IncRef(call->result);
+  return py_ref(call->result, call->convert);
 
-  // return
-  return py_ref(res.detach(), x.convert());
 }
 
 // [[Rcpp::export]]
@@ -2860,6 +5486,17 @@ PyObjectRef py_dict_get_keys(PyObjectRef dict) {
 // [[Rcpp::export]]
 CharacterVector py_dict_get_keys_as_str(PyObjectRef dict) {
 
+  // read the keys of plain dicts directly
+  if (PyDict_Check(dict)) {
+    CharacterVector keys(PyDict_Size(dict));
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    Py_ssize_t idx = 0;
+    while (PyDict_Next(dict, &pos, &key, &value))
+      SET_STRING_ELT(keys, idx++, as_r_name(key));
+    return keys;
+  }
+
   // get the dictionary keys
   PyObjectPtr py_keys(py_dict_get_keys_impl(dict));
 
@@ -2899,6 +5536,170 @@ CharacterVector py_dict_get_keys_as_str(PyObjectRef dict) {
 
 }
 
+namespace {
+
+// the R type of a column of records, as widened to hold another value;
+// NILSXP while only missing values (None) have been seen
+SEXPTYPE records_column_type(SEXPTYPE type, PyObject* value) {
+
+  if (type == VECSXP || value == Py_None)
+    return type;
+
+  SEXPTYPE valueType;
+  if (PyBool_Check(value)) {
+    valueType = LGLSXP;
+  } else if (PyInt_Check(value) || PyLong_Check(value)) {
+    // integers outside of R's integer range become doubles
+    long number = PyInt_AsLong(value);
+    if (number == -1 && PyErr_Occurred()) {
+      PyErr_Clear();
+      valueType = REALSXP;
+    } else if (number > INT_MAX || number <= INT_MIN) {
+      valueType = REALSXP;
+    } else {
+      valueType = INTSXP;
+    }
+  } else if (PyFloat_Check(value)) {
+    valueType = REALSXP;
+  } else if (PyUnicode_Check(value)) {
+    valueType = STRSXP;
+  } else {
+    return VECSXP;
+  }
+
+  if (type == NILSXP || type == valueType)
+    return valueType;
+
+  // logical < integer < double; strings only mix with strings
+  bool numeric = type != STRSXP && valueType != STRSXP;
+  if (!numeric)
+    return VECSXP;
+
+  return type == REALSXP || valueType == REALSXP ? REALSXP : INTSXP;
+
+}
+
+void records_column_set(SEXP column, R_xlen_t i, PyObject* value, bool convert) {
+
+  switch (TYPEOF(column)) {
+  case LGLSXP:
+    LOGICAL(column)[i] = value == Py_None ? NA_LOGICAL : value == Py_True;
+    break;
+  case INTSXP:
+    INTEGER(column)[i] = value == Py_None ? NA_INTEGER : (int) PyInt_AsLong(value);
+    break;
+  case REALSXP:
+    REAL(column)[i] = value == Py_None ? NA_REAL : PyFloat_AsDouble(value);
+    break;
+  case STRSXP:
+    SET_STRING_ELT(column, i, value == Py_None ? NA_STRING : as_utf8_charsxp(value));
+    break;
+  default:
+    if (value != Py_None)
+      SET_VECTOR_ELT(column, i, py_to_r(value, convert));
+    break;
+  }
+
+}
+
+} // end anonymous namespace
+
+// [[Rcpp::export]]
+SEXP py_records_to_df_impl(PyObjectRef records) {
+
+  bool convert = records.convert();
+  PyObject* rows = records.get();
+  if (!PyList_Check(rows) && !PyTuple_Check(rows))
+    stop("records must be a list or tuple of dicts");
+
+  Py_ssize_t n = PyObject_Size(rows);
+
+  // the columns, in order of first appearance, and their types (the dict
+  // maps each key to its column index)
+  PyObjectPtr index(PyDict_New());
+  std::vector<PyObject*> keys;
+  std::vector<SEXPTYPE> types;
+
+  // scan the keys and values of every record to find the columns and
+  // their types; records usually have the same keys in the same order, so
+  // look for each key at its position before looking it up
+  for (Py_ssize_t i = 0; i < n; i++) {
+
+    PyObject* row = PyList_Check(rows) ? PyList_GetItem(rows, i) : PyTuple_GetItem(rows, i);
+    if (!PyDict_Check(row))
+      stop("record %i is not a dict", (int) i + 1);
+
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    Py_ssize_t j = 0;
+    while (PyDict_Next(row, &pos, &key, &value)) {
+
+      Py_ssize_t column = j++;
+      if (column >= (Py_ssize_t) keys.size() || keys[column] != key) {
+        PyObject* existing = PyDict_GetItem(index, key);
+        if (existing != NULL) {
+          column = PyInt_AsLong(existing);
+        } else {
+          column = keys.size();
+          PyObjectPtr position(PyInt_FromLong(column));
+          if (PyDict_SetItem(index, key, position) != 0)
+            throw PythonException(py_fetch_error());
+          keys.push_back(key);
+          types.push_back(NILSXP);
+        }
+      }
+
+      types[column] = records_column_type(types[column], value);
+    }
+  }
+
+  // allocate the columns; columns with only missing values are logical
+  std::size_t ncol = keys.size();
+  List columns(ncol);
+  CharacterVector names(ncol);
+  for (std::size_t j = 0; j < ncol; j++) {
+    SEXPTYPE type = types[j] == NILSXP ? LGLSXP : types[j];
+    SEXP column = Rf_allocVector(type, n);
+    columns[j] = column;
+    switch (type) {
+    case LGLSXP:  std::fill(LOGICAL(column), LOGICAL(column) + n, NA_LOGICAL); break;
+    case INTSXP:  std::fill(INTEGER(column), INTEGER(column) + n, NA_INTEGER); break;
+    case REALSXP: std::fill(REAL(column), REAL(column) + n, NA_REAL); break;
+    case STRSXP:
+      for (Py_ssize_t i = 0; i < n; i++)
+        SET_STRING_ELT(column, i, NA_STRING);
+      break;
+    }
+    SET_STRING_ELT(names, j, as_r_name(keys[j]));
+  }
+
+  // fill the columns in a single pass over the records (the records are
+  // held by the list, so borrowed keys and values remain valid throughout)
+  for (Py_ssize_t i = 0; i < n; i++) {
+
+    PyObject* row = PyList_Check(rows) ? PyList_GetItem(rows, i) : PyTuple_GetItem(rows, i);
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    Py_ssize_t j = 0;
+    while (PyDict_Next(row, &pos, &key, &value)) {
+      Py_ssize_t column = j++;
+      if (column >= (Py_ssize_t) ncol || keys[column] != key)
+        column = PyInt_AsLong(PyDict_GetItem(index, key));
+      records_column_set(VECTOR_ELT(columns, column), i, value, convert);
+    }
+  }
+
+  columns.names() = names;
+  // compact row names; R stores these as doubles for long data frames
+  if (n > INT_MAX)
+    columns.attr("row.names") = NumericVector::create(NA_REAL, -(double) n);
+  else
+    columns.attr("row.names") = IntegerVector::create(NA_INTEGER, -(int) n);
+  columns.attr("class") = "data.frame";
+  return columns;
+
+}
+
 
 // [[Rcpp::export]]
 PyObjectRef py_tuple(const List& items, bool convert) {
@@ -3045,6 +5846,220 @@ SEXP py_iter_next(PyObjectRef iterator, RObject completed) {
   }
 }
 
+// [[Rcpp::export]]
+SEXP py_iter_next_batch(PyObjectRef iterator, int n, RObject completed) {
+
+  if (n < 1)
+    stop("batch size must be positive");
+
+  // collect up to n items (PyObjectPtr can't be stored in a vector, so
+  // ensure the items are released if we fail part way)
+  std::vector<PyObject*> items;
+  items.reserve(std::min(n, 65536));
+  struct Release {
+    std::vector<PyObject*>& items;
+    ~Release() {
+      for (std::size_t i = 0; i < items.size(); i++)
+        Py_DecRef(items[i]);
+    }
+  } release = { items };
+
+  while (items.size() < (std::size_t) n) {
+    PyObject* item = PyIter_Next(iterator);
+    if (item == NULL) {
+      if (PyErr_Occurred())
+        throw PythonException(py_fetch_error());
+      break;
+    }
+    items.push_back(item);
+  }
+
+  if (items.empty())
+    return completed;
+
+  if (!iterator.convert()) {
+    List list(items.size());
+    for (std::size_t i = 0; i < items.size(); i++) {
+      PyObject* item = items[i];
+      items[i] = NULL;
+      list[i] = py_ref(item, false);
+    }
+    items.clear();
+    return list;
+  }
+
+  // convert the items as a list, so that batches of scalars of the same
+  // type become atomic vectors
+  PyObjectPtr list(PyList_New(items.size()));
+  if (list.is_null())
+    throw PythonException(py_fetch_error());
+  for (std::size_t i = 0; i < items.size(); i++)
+    PyList_SetItem(list, i, items[i]);
+  items.clear();
+
+  return py_to_r(list, true);
+
+}
+
+
+// Cache of the code objects compiled for py_run_string(), py_eval() and
+// py_run_file(), so that code run repeatedly (e.g. in loops, or by knitr)
+// needn't be parsed and compiled each time. Entries are keyed by the mode,
+// filename and source code (files are read each time they're run, and keyed
+// by their path and contents), and the least recently used entries are
+// evicted once the cache holds 'reticulate.code_cache_size' entries (128 by
+// default; 0 disables the cache). Code objects are immutable, so can be run
+// any number of times.
+typedef std::list< std::pair<std::string, PyObject*> > PyCodeCacheList;
+typedef std::unordered_map<std::string, PyCodeCacheList::iterator> PyCodeCacheIndex;
+
+PyCodeCacheList s_code_cache;
+PyCodeCacheIndex s_code_cache_index;
+double s_code_cache_hits = 0;
+double s_code_cache_misses = 0;
+
+const std::size_t s_code_cache_default_size = 128;
+
+std::size_t py_code_cache_size() {
+  SEXP value = Rf_GetOption1(Rf_install("reticulate.code_cache_size"));
+  if (Rf_length(value) == 1 && (TYPEOF(value) == INTSXP || TYPEOF(value) == REALSXP)) {
+    int n = Rf_asInteger(value);
+    return n == NA_INTEGER || n < 0 ? 0 : (std::size_t) n;
+  }
+  return s_code_cache_default_size;
+}
+
+void py_code_cache_trim(std::size_t size) {
+  while (s_code_cache.size() > size) {
+    s_code_cache_index.erase(s_code_cache.back().first);
+    Py_DecRef(s_code_cache.back().second);
+    s_code_cache.pop_back();
+  }
+}
+
+// [[Rcpp::export]]
+void py_code_cache_clear_impl() {
+  py_code_cache_trim(0);
+  s_code_cache_hits = s_code_cache_misses = 0;
+}
+
+// [[Rcpp::export]]
+SEXP py_code_cache_stats_impl() {
+  List result;
+  result["hits"] = s_code_cache_hits;
+  result["misses"] = s_code_cache_misses;
+  result["entries"] = (double) s_code_cache.size();
+  result["size"] = (double) py_code_cache_size();
+  return result;
+}
+
+PyObject* py_compile_code(const char* code, const char* filename,
+                          int mode, int optimize)
+{
+  if (Py_CompileStringExFlags != NULL)
+    return Py_CompileStringExFlags(code, filename, mode, NULL, optimize);
+  else
+    return Py_CompileString(code, filename, mode);
+}
+
+// 'kind' distinguishes keys for source code run as a string from those
+// for the contents of a file
+std::string py_code_cache_key(char kind, const char* filename, int mode,
+                              int optimize, const std::string& source)
+{
+  std::ostringstream key;
+  key << kind << mode << ':' << optimize << ':' << filename << '\0' << source;
+  return key.str();
+}
+
+// returns a new reference to the cached code object, or NULL
+PyObject* py_code_cache_get(const std::string& key) {
+
+  PyCodeCacheIndex::iterator it = s_code_cache_index.find(key);
+  if (it == s_code_cache_index.end()) {
+    s_code_cache_misses++;
+    return NULL;
+  }
+
+  s_code_cache_hits++;
+  s_code_cache.splice(s_code_cache.begin(), s_code_cache, it->second);
+  Py_IncRef(it->second->second);
+  return it->second->second;
+
+}
+
+// add a code object (borrowed) to the cache
+void py_code_cache_put(const std::string& key, PyObject* compiled) {
+
+  std::size_t size = py_code_cache_size();
+  py_code_cache_trim(size == 0 ? 0 : size - 1);
+  if (size == 0)
+    return;
+
+  Py_IncRef(compiled);
+  s_code_cache.push_front(std::make_pair(key, compiled));
+  s_code_cache_index[key] = s_code_cache.begin();
+
+}
+
+// returns a new reference to the code object compiled for 'code' (or NULL,
+// with the Python error set, if it can't be compiled)
+PyObject* py_compile_cached(const std::string& code, const char* filename,
+                            int mode, int optimize)
+{
+  if (py_code_cache_size() == 0) {
+    py_code_cache_trim(0);
+    return py_compile_code(code.c_str(), filename, mode, optimize);
+  }
+
+  std::string key = py_code_cache_key('s', filename, mode, optimize, code);
+  PyObject* compiled = py_code_cache_get(key);
+  if (compiled != NULL)
+    return compiled;
+
+  compiled = py_compile_code(code.c_str(), filename, mode, optimize);
+  if (compiled != NULL)
+    py_code_cache_put(key, compiled);
+
+  return compiled;
+}
+
+// returns a new reference to the code object compiled for a file (or
+// NULL, with the Python error set, if it can't be compiled); files are
+// looked up by their path and contents, so the code compiled for a file is
+// reused for as long as the file is unchanged (reading the file is cheap,
+// next to compiling it)
+PyObject* py_compile_file_cached(const std::string& file) {
+
+  std::ifstream ifs(file.c_str(), std::ios::in | std::ios::binary);
+  if (!ifs)
+    stop("Unable to open file '%s'", file);
+
+  std::ostringstream stream;
+  stream << ifs.rdbuf();
+  std::string contents = stream.str();
+
+  // the source is passed to Python as a C string
+  if (contents.find('\0') != std::string::npos)
+    stop("Unable to run file '%s': source code cannot contain null bytes", file);
+
+  if (py_code_cache_size() == 0) {
+    py_code_cache_trim(0);
+    return py_compile_code(contents.c_str(), file.c_str(), Py_file_input, -1);
+  }
+
+  std::string key = py_code_cache_key('f', file.c_str(), Py_file_input, -1, contents);
+  PyObject* compiled = py_code_cache_get(key);
+  if (compiled != NULL)
+    return compiled;
+
+  compiled = py_compile_code(contents.c_str(), file.c_str(), Py_file_input, -1);
+  if (compiled != NULL)
+    py_code_cache_put(key, compiled);
+
+  return compiled;
+
+}
 
 // [[Rcpp::export]]
 SEXP py_run_string_impl(const std::string& code,
@@ -3057,13 +6072,18 @@ SEXP py_run_string_impl(const std::string& code,
   PyObject* main = PyImport_AddModule("__main__");
   PyObject* globals = PyModule_GetDict(main);
 
+  // compile the code (as PyRun_String() would, with the same filename)
+  PyObjectPtr compiled(py_compile_cached(code, "<string>", Py_file_input, -1));
+  if (compiled.is_null())
+    throw PythonException(py_fetch_error());
+
   if (local) {
 
     // create dictionary to capture locals
     PyObjectPtr locals(PyDict_New());
 
     // run the requested code
-    PyObjectPtr res(PyRun_StringFlags(code.c_str(), Py_file_input, globals, locals, NULL));
+    PyObjectPtr res(PyEval_EvalCode(compiled, globals, locals));
     if (res.is_null())
       throw PythonException(py_fetch_error());
 
@@ -3073,7 +6093,7 @@ SEXP py_run_string_impl(const std::string& code,
   } else {
 
     // run the requested code
-    PyObjectPtr res(PyRun_StringFlags(code.c_str(), Py_file_input, globals, globals, NULL));
+    PyObjectPtr res(PyEval_EvalCode(compiled, globals, globals));
     if (res.is_null())
       throw PythonException(py_fetch_error());
 
@@ -3089,8 +6109,9 @@ SEXP py_run_string_impl(const std::string& code,
 PyObjectRef py_run_file_impl(const std::string& file,
                       bool local = false,
                       bool convert = true) {
-  FILE* fp = fopen(file.c_str(), "rb");
-  if (fp == NULL) stop("Unable to open file '%s'", file);
+  PyObjectPtr compiled(py_compile_file_cached(file));
+  if (compiled.is_null())
+    throw PythonException(py_fetch_error());
 
   PyObject* main = PyImport_AddModule("__main__");  // borrowed reference
   PyObject* globals = PyModule_GetDict(main);       // borrowed reference
@@ -3111,8 +6132,7 @@ PyObjectRef py_run_file_impl(const std::string& file,
   if (PyDict_SetItemString(locals, "__cached__", Py_None) < 0)
     throw PythonException(py_fetch_error());
 
-  PyObjectPtr res(PyRun_FileEx(fp, file.c_str(), Py_file_input, globals,
-                               locals, 1));  // 1 here closes fp before it returns
+  PyObjectPtr res(PyEval_EvalCode(compiled, globals, locals));
 
   if (res.is_null())
     throw PythonException(py_fetch_error());
@@ -3132,12 +6152,7 @@ PyObjectRef py_run_file_impl(const std::string& file,
 // [[Rcpp::export]]
 SEXP py_eval_impl(const std::string& code, bool convert = true) {
   // compile the code
-  PyObjectPtr compiledCode;
-  if (Py_CompileStringExFlags != NULL)
-    compiledCode.assign(Py_CompileStringExFlags(code.c_str(), "reticulate_eval", Py_eval_input, NULL, 0));
-  else
-    compiledCode.assign(Py_CompileString(code.c_str(), "reticulate_eval", Py_eval_input));
-
+  PyObjectPtr compiledCode(py_compile_cached(code, "reticulate_eval", Py_eval_input, 0));
 
   if (compiledCode.is_null())
     throw PythonException(py_fetch_error());
@@ -3217,6 +6232,170 @@ SEXPTYPE nullable_typename_to_sexptype (const std::string& name) {
   Rcpp::stop("Can't cast column with type name: " + name);
 }
 
+// read the values of a masked pandas extension array (IntegerArray,
+// FloatingArray or BooleanArray) in bulk, through the NumPy arrays holding
+// its data and missingness mask; returns R_NilValue for arrays which aren't
+// backed by NumPy arrays
+SEXP pandas_nullable_masked_values(PyObject* series, SEXPTYPE rtype) {
+
+  PyObjectPtr array(PyObject_GetAttrString(series, "array"));
+  if (array.is_null())
+    throw PythonException(py_fetch_error());
+
+  if (!PyObject_HasAttrString(array, "_data") || !PyObject_HasAttrString(array, "_mask"))
+    return R_NilValue;
+
+  PyObjectPtr data(PyObject_GetAttrString(array, "_data"));
+  PyObjectPtr mask(PyObject_GetAttrString(array, "_mask"));
+  if (data.is_null() || mask.is_null())
+    throw PythonException(py_fetch_error());
+
+  if (!isPyArray(data) || !isPyArray(mask))
+    return R_NilValue;
+
+  RObject converted = py_to_r(data, true);
+  RObject values = Rf_coerceVector(converted, rtype);
+  RObject missing = py_to_r(mask, true);
+  if (TYPEOF(missing) != LGLSXP || Rf_xlength(missing) != Rf_xlength(values))
+    return R_NilValue;
+
+  values.attr("dim") = R_NilValue;
+
+  const int* pMissing = LOGICAL(missing);
+  R_xlen_t n = Rf_xlength(values);
+  for (R_xlen_t i = 0; i < n; i++) {
+    if (!pMissing[i])
+      continue;
+    switch (rtype) {
+    case INTSXP:  INTEGER(values)[i] = NA_INTEGER; break;
+    case REALSXP: REAL(values)[i] = NA_REAL; break;
+    case LGLSXP:  LOGICAL(values)[i] = NA_LOGICAL; break;
+    }
+  }
+
+  return values;
+
+}
+
+// the name of the time zone of a DatetimeTZDtype, as understood by R, or
+// an empty string if there's no (known) time zone
+std::string pandas_tz_name(PyObject* dtype) {
+
+  if (!PyObject_HasAttrString(dtype, "tz"))
+    return std::string();
+
+  PyObjectPtr tz(PyObject_GetAttrString(dtype, "tz"));
+  if (tz.is_null() || py_is_none(tz)) {
+    PyErr_Clear();
+    return std::string();
+  }
+
+  // pytz time zones have a 'zone'; zoneinfo.ZoneInfo has a 'key'
+  const char* attrs[] = { "zone", "key" };
+  for (std::size_t i = 0; i < sizeof(attrs) / sizeof(attrs[0]); i++) {
+    if (!PyObject_HasAttrString(tz, attrs[i]))
+      continue;
+    PyObjectPtr zone(PyObject_GetAttrString(tz, attrs[i]));
+    if (zone.is_null()) {
+      PyErr_Clear();
+      continue;
+    }
+    if (is_python_str(zone))
+      return as_std_string(zone);
+  }
+
+  // fixed-offset zones (e.g. datetime.timezone.utc) have neither, but those
+  // with an offset of zero are UTC
+  PyObjectPtr offset(PyObject_CallMethod(tz, "utcoffset", "O", Py_None));
+  if (offset.is_null() || py_is_none(offset)) {
+    PyErr_Clear();
+    return std::string();
+  }
+
+  PyObjectPtr seconds(PyObject_CallMethod(offset, "total_seconds", NULL));
+  if (seconds.is_null()) {
+    PyErr_Clear();
+    return std::string();
+  }
+
+  double value = PyFloat_AsDouble(seconds);
+  if (value == -1.0 && PyErr_Occurred()) {
+    PyErr_Clear();
+    return std::string();
+  }
+
+  if (value == 0)
+    return "UTC";
+
+  return std::string();
+
+}
+
+// convert a datetime64 Series to POSIXct by viewing its values as int64
+// counts of its unit (e.g. nanoseconds) since the epoch (this is how pandas
+// stores them; NaT is the smallest int64); the time zone, if any, is kept in
+// the 'tzone' attribute
+SEXP pandas_datetime_values(PyObject* series, PyObject* dtype, const std::string& name) {
+
+  if (!haveNumPy())
+    return R_NilValue;
+
+  // tz-aware Series return their values in UTC
+  PyObjectPtr values(PyObject_GetAttrString(series, "values"));
+  if (values.is_null())
+    throw PythonException(py_fetch_error());
+
+  // pandas >= 2.0 supports resolutions other than nanoseconds; these are
+  // read in their own unit (a cast to nanoseconds would overflow for dates
+  // outside 1677-2262), which is named by the dtype, e.g. "datetime64[us, UTC]"
+  std::string unit = name.substr(11, name.find_first_of(",]", 11) - 11);
+  int64_t units;
+  if (unit == "s")
+    units = 1;
+  else if (unit == "ms")
+    units = 1000;
+  else if (unit == "us")
+    units = 1000000;
+  else if (unit == "ns")
+    units = 1000000000;
+  else
+    return R_NilValue;
+
+  PyObjectPtr i8(PyObject_CallMethod(values, "view", "s", "i8"));
+  if (i8.is_null())
+    throw PythonException(py_fetch_error());
+
+  if (!isPyArray(i8) || PyArray_NDIM((PyArrayObject*) i8.get()) != 1)
+    return R_NilValue;
+
+  PyArrayObject* array = (PyArrayObject*) i8.get();
+  npy_intp n = PyArray_DIMS(array)[0];
+  npy_intp stride = PyArray_STRIDES(array)[0];
+  const char* data = (const char*) PyArray_DATA(array);
+
+  NumericVector posixct(n);
+  for (npy_intp i = 0; i < n; i++) {
+    int64_t value;
+    std::memcpy(&value, data + i * stride, sizeof(int64_t));
+    if (value == INT64_MIN) {
+      posixct[i] = NA_REAL;
+    } else {
+      int64_t seconds = value / units;
+      int64_t remainder = value % units;
+      posixct[i] = (double) seconds + (double) remainder / units;
+    }
+  }
+
+  posixct.attr("class") = CharacterVector::create("POSIXct", "POSIXt");
+
+  std::string tz = pandas_tz_name(dtype);
+  if (!tz.empty())
+    posixct.attr("tzone") = tz;
+
+  return posixct;
+
+}
+
 // [[Rcpp::export]]
 SEXP py_convert_pandas_series(PyObjectRef series) {
 
@@ -3284,6 +6463,14 @@ SEXP py_convert_pandas_series(PyObjectRef series) {
     // if a time zone is present, dtype is "object"
     PyObject_HasAttrString(series, "dt")) {
 
+    // datetime64 values can be read in bulk
+    if (name.compare(0, 11, "datetime64[") == 0) {
+      SEXP posixct = pandas_datetime_values(series, dtype, name);
+      if (posixct != R_NilValue)
+        return posixct;
+    }
+
+    // otherwise, convert each element through pd.Timestamp.timestamp()
     // pd.Series.items() returns an iterator over (index, value) pairs
     PyObjectPtr items(PyObject_CallMethod(series, "items", NULL));
 
@@ -3334,7 +6521,16 @@ SEXP py_convert_pandas_series(PyObjectRef series) {
 
     // IIFE pattern
     R_obj = [&]() {
-      switch (nullable_typename_to_sexptype(name)) {
+      SEXPTYPE rtype = nullable_typename_to_sexptype(name);
+
+      // numeric and logical arrays can be read through their data and mask
+      if (rtype != STRSXP) {
+        RObject values = pandas_nullable_masked_values(series, rtype);
+        if (values != R_NilValue)
+          return values;
+      }
+
+      switch (rtype) {
       case INTSXP: return pandas_nullable_collect_values<INTSXP>(series);
       case REALSXP: return pandas_nullable_collect_values<REALSXP>(series);
       case LGLSXP: return pandas_nullable_collect_values<LGLSXP>(series);
@@ -3355,16 +6551,128 @@ SEXP py_convert_pandas_series(PyObjectRef series) {
 
 }
 
+// read the columns of a DataFrame through its block manager: each NumPy
+// block holding numeric or logical data is a 2D array with a row per
+// column, so those columns can be converted from views of the block,
+// rather than constructing a Series for each column. other columns are
+// delegated to py_convert_pandas_series(). returns false if the frame's
+// internals aren't as expected
+bool pandas_df_block_columns(PyObjectRef df, std::vector<RObject>* pColumns) {
+
+  // the block manager was known as '_data' before pandas 1.1
+  const char* manager = PyObject_HasAttrString(df, "_mgr") ? "_mgr" : "_data";
+  PyObjectPtr mgr(PyObject_GetAttrString(df, manager));
+  if (mgr.is_null()) {
+    PyErr_Clear();
+    return false;
+  }
+
+  PyObjectPtr blocks(PyObject_GetAttrString(mgr, "blocks"));
+  PyObjectPtr columns(PyObject_GetAttrString(df, "columns"));
+  if (blocks.is_null() || columns.is_null() || !PyTuple_Check(blocks)) {
+    PyErr_Clear();
+    return false;
+  }
+
+  Py_ssize_t ncol = PyObject_Size(columns);
+  if (ncol < 0) {
+    PyErr_Clear();
+    return false;
+  }
+
+  std::vector<RObject> result(ncol);
+  std::vector<bool> converted(ncol, false);
+
+  Py_ssize_t nblocks = PyTuple_Size(blocks);
+  for (Py_ssize_t i = 0; i < nblocks; i++) {
+
+    PyObject* block = PyTuple_GetItem(blocks, i);  // borrowed
+    PyObjectPtr placement(PyObject_GetAttrString(block, "mgr_locs"));
+    if (placement.is_null()) {
+      PyErr_Clear();
+      return false;
+    }
+
+    PyObjectPtr locs(PyObject_GetAttrString(placement, "as_array"));
+    PyObjectPtr values(PyObject_GetAttrString(block, "values"));
+    if (locs.is_null() || values.is_null()) {
+      PyErr_Clear();
+      return false;
+    }
+
+    if (!isPyArray(values) || PyArray_NDIM((PyArrayObject*) values.get()) != 2)
+      continue;
+
+    // datetimes and objects get special treatment per-Series
+    int typenum = PyArray_TYPE((PyArrayObject*) values.get());
+    bool numeric = typenum == NPY_HALF || (typenum <= NPY_CDOUBLE && typenum != NPY_LONGDOUBLE);
+    if (!numeric)
+      continue;
+
+    std::vector<double> positions = as< std::vector<double> >(py_to_r(locs, true));
+    for (std::size_t j = 0; j < positions.size(); j++) {
+
+      Py_ssize_t position = (Py_ssize_t) positions[j];
+      if (position < 0 || position >= ncol)
+        return false;
+
+      PyObjectPtr column(PySequence_GetItem(values, j));
+      if (column.is_null())
+        throw PythonException(py_fetch_error());
+
+      result[position] = py_to_r(column, df.convert());
+      converted[position] = true;
+
+    }
+
+  }
+
+  // the remaining columns are converted via the corresponding Series
+  PyObjectPtr iloc;
+  PyObjectPtr all(PySlice_New(NULL, NULL, NULL));
+  for (Py_ssize_t i = 0; i < ncol; i++) {
+
+    if (converted[i])
+      continue;
+
+    if (iloc.is_null()) {
+      iloc.assign(PyObject_GetAttrString(df, "iloc"));
+      if (iloc.is_null())
+        throw PythonException(py_fetch_error());
+    }
+
+    PyObjectPtr key(PyTuple_New(2));
+    Py_IncRef(all);
+    PyTuple_SetItem(key, 0, all);
+    PyTuple_SetItem(key, 1, PyLong_FromLong(i));
+
+    PyObject* series = PyObject_GetItem(iloc, key);
+    if (series == NULL)
+      throw PythonException(py_fetch_error());
+
+    PyObjectRef series_ref(series, df.convert());
+    result[i] = py_convert_pandas_series(series_ref);
+
+  }
+
+  pColumns->swap(result);
+  return true;
+
+}
+
 // [[Rcpp::export]]
 SEXP py_convert_pandas_df(PyObjectRef df) {
 
-  // pd.DataFrame.items() returns an iterator over (column name, Series) pairs
+  std::vector<RObject> list;
+  if (pandas_df_block_columns(df, &list))
+    return List(list.begin(), list.end());
+
+  // otherwise, pd.DataFrame.items() returns an iterator over
+  // (column name, Series) pairs
   PyObjectPtr items(PyObject_CallMethod(df, "items", NULL));
   if (! (PyObject_HasAttrString(items, "__next__") || PyObject_HasAttrString(items, "next")))
     stop("Cannot iterate over object");
 
-  std::vector<RObject> list;
-
   while (true) {
 
     // get next tuple
@@ -3391,9 +6699,190 @@ SEXP py_convert_pandas_df(PyObjectRef df) {
 
 }
 
+// Arrow C stream interface ---------------------------------------------------
+//
+// Tabular data is exchanged with Arrow implementations (e.g. the arrow R
+// package, pyarrow, polars) by moving an ArrowArrayStream between them;
+// the underlying buffers are never copied. See
+// https://arrow.apache.org/docs/format/CStreamInterface.html
+
+struct ArrowSchema;
+struct ArrowArray;
+
+struct ArrowArrayStream {
+  int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+  int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+  const char* (*get_last_error)(struct ArrowArrayStream*);
+  void (*release)(struct ArrowArrayStream*);
+  void* private_data;
+};
+
+void arrow_stream_release(ArrowArrayStream* stream) {
+  if (stream->release != NULL)
+    stream->release(stream);
+  std::free(stream);
+}
+
+void arrow_stream_finalize(SEXP ptr) {
+  ArrowArrayStream* stream = (ArrowArrayStream*) R_ExternalPtrAddr(ptr);
+  if (stream == NULL)
+    return;
+  arrow_stream_release(stream);
+  R_ClearExternalPtr(ptr);
+}
+
+void arrow_stream_capsule_destructor(PyObject* capsule) {
+  ArrowArrayStream* stream =
+    (ArrowArrayStream*) PyCapsule_GetPointer(capsule, "arrow_array_stream");
+  if (stream != NULL)
+    arrow_stream_release(stream);
+  else
+    PyErr_Clear();
+}
+
+ArrowArrayStream* arrow_stream_new() {
+  ArrowArrayStream* stream = (ArrowArrayStream*) std::calloc(1, sizeof(ArrowArrayStream));
+  if (stream == NULL)
+    stop("failed to allocate ArrowArrayStream");
+  return stream;
+}
+
+ArrowArrayStream* arrow_stream_get(SEXP ptr) {
+  if (TYPEOF(ptr) != EXTPTRSXP || R_ExternalPtrAddr(ptr) == NULL)
+    stop("invalid ArrowArrayStream pointer");
+  return (ArrowArrayStream*) R_ExternalPtrAddr(ptr);
+}
+
+// allocate an (empty) ArrowArrayStream owned by R, into which a producer
+// can export a stream
+// [[Rcpp::export]]
+SEXP py_arrow_c_stream_allocate() {
+  SEXP ptr = PROTECT(R_MakeExternalPtr(arrow_stream_new(), R_NilValue, R_NilValue));
+  R_RegisterCFinalizer(ptr, arrow_stream_finalize);
+  UNPROTECT(1);
+  return ptr;
+}
+
+// the address of an ArrowArrayStream, as accepted by e.g. the arrow R
+// package's import_from_c() and export_to_c() methods
+// [[Rcpp::export]]
+double py_arrow_c_stream_address(SEXP ptr) {
+  return (double) (uintptr_t) arrow_stream_get(ptr);
+}
+
+// export a stream from a Python object into an ArrowArrayStream owned by R,
+// using the Arrow PyCapsule interface (__arrow_c_stream__()) if available,
+// or pyarrow's (older) _export_to_c() method otherwise
+// [[Rcpp::export]]
+SEXP py_arrow_c_stream_import(PyObjectRef x) {
+
+  RObject ptr = py_arrow_c_stream_allocate();
+  ArrowArrayStream* stream = arrow_stream_get(ptr);
+
+  if (PyObject_HasAttrString(x, "__arrow_c_stream__")) {
+
+    PyObjectPtr capsule(PyObject_CallMethod(x, "__arrow_c_stream__", NULL));
+    if (capsule.is_null())
+      throw PythonException(py_fetch_error());
+
+    ArrowArrayStream* source =
+      (ArrowArrayStream*) PyCapsule_GetPointer(capsule, "arrow_array_stream");
+    if (source == NULL)
+      throw PythonException(py_fetch_error());
+
+    // move the stream, marking the source as released
+    std::memcpy(stream, source, sizeof(ArrowArrayStream));
+    source->release = NULL;
+
+  } else if (PyObject_HasAttrString(x, "_export_to_c")) {
+
+    PyObjectPtr address(PyLong_FromVoidPtr(stream));
+    PyObjectPtr result(PyObject_CallMethod(x, "_export_to_c", "O", address.get()));
+    if (result.is_null())
+      throw PythonException(py_fetch_error());
+
+  } else {
+    stop("Python object does not implement the Arrow C stream interface");
+  }
+
+  return ptr;
+
+}
+
+// move an ArrowArrayStream owned by R into a PyCapsule (as described by the
+// Arrow PyCapsule interface), returning a tuple of the capsule and the
+// address of the stream it holds
+// [[Rcpp::export]]
+PyObjectRef py_arrow_c_stream_export(SEXP ptr) {
+
+  ArrowArrayStream* source = arrow_stream_get(ptr);
+  if (source->release == NULL)
+    stop("ArrowArrayStream has already been released");
+
+  ArrowArrayStream* stream = arrow_stream_new();
+  std::memcpy(stream, source, sizeof(ArrowArrayStream));
+  source->release = NULL;
+
+  PyObject* capsule = PyCapsule_New(stream, "arrow_array_stream",
+                                    arrow_stream_capsule_destructor);
+  if (capsule == NULL) {
+    arrow_stream_release(stream);
+    throw PythonException(py_fetch_error());
+  }
+
+  PyObjectPtr result(PyTuple_New(2));
+  PyTuple_SetItem(result, 0, capsule);
+  PyTuple_SetItem(result, 1, PyLong_FromVoidPtr(stream));
+
+  return py_ref(result.detach(), false);
+
+}
+
+// compute the NA mask of a numeric vector whose data can be read directly
+// (in parallel, for long vectors)
+struct NaMaskRange {
+  SEXPTYPE type;
+  const void* src;
+  bool* dst;
+};
+
+void na_mask_range(void* data, R_xlen_t begin, R_xlen_t end) {
+
+  NaMaskRange* range = (NaMaskRange*) data;
+  bool* dst = range->dst;
+
+  switch (range->type) {
+  case LGLSXP: {
+    const int* src = (const int*) range->src;
+    for (R_xlen_t i = begin; i < end; i++)
+      dst[i] = (src[i] == NA_LOGICAL);
+    break;
+  }
+  case INTSXP: {
+    const int* src = (const int*) range->src;
+    for (R_xlen_t i = begin; i < end; i++)
+      dst[i] = (src[i] == NA_INTEGER);
+    break;
+  }
+  case REALSXP: {
+    const double* src = (const double*) range->src;
+    for (R_xlen_t i = begin; i < end; i++)
+      dst[i] = ISNAN(src[i]);
+    break;
+  }
+  case CPLXSXP: {
+    const Rcomplex* src = (const Rcomplex*) range->src;
+    for (R_xlen_t i = begin; i < end; i++)
+      dst[i] = (ISNAN(src[i].r) || ISNAN(src[i].i));
+    break;
+  }
+  }
+
+}
+
 PyObject* na_mask (SEXP x) {
 
-  const size_t n(LENGTH(x));
+  const R_xlen_t n(XLENGTH(x));
   npy_intp dims(n);
 
   PyObject* mask(PyArray_SimpleNew(1, &dims, NPY_BOOL));
@@ -3404,7 +6893,18 @@ PyObject* na_mask (SEXP x) {
   bool* data = (bool*) PyArray_DATA((PyArrayObject*) mask);
   if (!data) throw PythonException(py_fetch_error());
 
-  size_t i;
+  // the data of ALTREP vectors is read element by element below, as
+  // reading it may call back into R
+  int type = TYPEOF(x);
+  bool numeric = type == LGLSXP || type == INTSXP || type == REALSXP || type == CPLXSXP;
+  if (numeric && !ALTREP(x)) {
+    NaMaskRange range = { (SEXPTYPE) type, DATAPTR(x), data };
+    double bytes = (double) n * (r_element_size(type) + sizeof(bool));
+    reticulate::parallel::for_range(n, bytes, na_mask_range, &range);
+    return mask;
+  }
+
+  R_xlen_t i;
 
   // This is modified from R primitive do_isna - backing the `is.na()`:
   // https://github.com/wch/r-source/blob/6b5d4ca5d1e3b4b9e4bbfb8f75577aff396a378a/src/main/coerce.c#L2221
@@ -3535,7 +7035,7 @@ PyObjectRef r_convert_dataframe(RObject dataframe, bool convert) {
     RObject column = VECTOR_ELT(dataframe, i);
 
     // ensure name is converted to appropriate encoding
-    PyObjectPtr name(as_python_str(names[i]));
+    PyObjectPtr name(as_python_name(STRING_ELT(names, i)));
 
     int status = 0;
 
@@ -3580,6 +7080,182 @@ PyObjectRef r_convert_dataframe(RObject dataframe, bool convert) {
   return py_ref(dict.detach(), convert);
 }
 
+// Conversion between Matrix's dgCMatrix, dgRMatrix and dgTMatrix and
+// scipy.sparse's CSC, CSR and COO matrices. The data and index vectors of R
+// matrices are shared with SciPy (as read-only NumPy arrays, as for other R
+// vectors); the arrays of SciPy matrices are copied directly into the slots
+// of the R matrix (or, with `reticulate.numpy_altrep`, viewed when their
+// memory is laid out as R would lay it out).
+namespace {
+
+PyObject* r_to_py_sparse_array(SEXP matrix, const char* slot) {
+  RObject value(R_do_slot(matrix, Rf_install(slot)));
+  return r_to_py_numpy(value, false);
+}
+
+SEXP py_to_r_sparse_array(PyObject* matrix, const char* name, SEXPTYPE type) {
+
+  PyObjectPtr object(PyObject_GetAttrString(matrix, name));
+  if (object.is_null())
+    throw PythonException(py_fetch_error());
+
+  if (!isPyArray(object) || PyArray_NDIM((PyArrayObject*) object.get()) != 1)
+    stop("sparse matrix attribute '%s' is not a 1-dimensional NumPy array", name);
+
+  PyArrayObject* array = (PyArrayObject*) object.get();
+  if (option_is_true("reticulate.numpy_altrep") &&
+      reticulate::altrep::numpy_view_type(array) == type)
+  {
+    return reticulate::altrep::numpy_view(array, type);
+  }
+
+  RObject result(Rf_allocVector(type, PyArray_SIZE(array)));
+  if (PyArray_SIZE(array) > 0)
+    numpy_copy_into(array, result);
+  return result;
+
+}
+
+// a Python number as a double, raising the Python error on failure
+double py_sparse_size(PyObject* value) {
+  double n = PyFloat_AsDouble(value);
+  if (n == -1.0 && PyErr_Occurred())
+    throw PythonException(py_fetch_error());
+  return n;
+}
+
+// R's integer vectors can hold the (possibly 64-bit) indices of a scipy
+// matrix as long as its dimensions and number of non-zeros fit
+void check_sparse_size(PyObject* matrix) {
+  PyObjectPtr nnz(PyObject_GetAttrString(matrix, "nnz"));
+  if (nnz.is_null())
+    throw PythonException(py_fetch_error());
+  double n = py_sparse_size(nnz);
+  if (n > INT_MAX)
+    stop("sparse matrix has %.0f non-zero elements, more than Matrix supports", n);
+}
+
+} // end anonymous namespace
+
+// [[Rcpp::export]]
+PyObjectRef r_to_py_sparse_impl(RObject x, bool convert) {
+
+  // (subclasses of the Matrix classes are converted as their superclass)
+  static const char* classes[] = { "dgCMatrix", "dgRMatrix", "dgTMatrix", "" };
+  int klass = R_check_class_etc(x, classes);
+  IntegerVector dim(R_do_slot(x, Rf_install("Dim")));
+
+  PyObjectPtr arrays;
+  const char* constructor;
+  if (klass == 0) {
+    constructor = "csc_matrix";
+    arrays.assign(PyTuple_New(3));
+    PyTuple_SetItem(arrays, 0, r_to_py_sparse_array(x, "x"));
+    PyTuple_SetItem(arrays, 1, r_to_py_sparse_array(x, "i"));
+    PyTuple_SetItem(arrays, 2, r_to_py_sparse_array(x, "p"));
+  } else if (klass == 1) {
+    constructor = "csr_matrix";
+    arrays.assign(PyTuple_New(3));
+    PyTuple_SetItem(arrays, 0, r_to_py_sparse_array(x, "x"));
+    PyTuple_SetItem(arrays, 1, r_to_py_sparse_array(x, "j"));
+    PyTuple_SetItem(arrays, 2, r_to_py_sparse_array(x, "p"));
+  } else if (klass == 2) {
+    constructor = "coo_matrix";
+    PyObject* indices = PyTuple_New(2);
+    PyTuple_SetItem(indices, 0, r_to_py_sparse_array(x, "i"));
+    PyTuple_SetItem(indices, 1, r_to_py_sparse_array(x, "j"));
+    arrays.assign(PyTuple_New(2));
+    PyTuple_SetItem(arrays, 0, r_to_py_sparse_array(x, "x"));
+    PyTuple_SetItem(arrays, 1, indices);
+  } else {
+    CharacterVector names(x.attr("class"));
+    std::string name = names.size() > 0 ? as<std::string>(names[0]) : "";
+    stop("unsupported sparse matrix class '%s'", name);
+  }
+
+  PyObjectPtr module(PyImport_ImportModule("scipy.sparse"));
+  if (module.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr type(PyObject_GetAttrString(module, constructor));
+  if (type.is_null())
+    throw PythonException(py_fetch_error());
+
+  PyObjectPtr args(PyTuple_New(1));
+  PyTuple_SetItem(args, 0, arrays.detach());
+
+  PyObjectPtr kwargs(PyDict_New());
+  PyObjectPtr shape(Py_BuildValue("(ii)", dim[0], dim[1]));
+  if (shape.is_null() || PyDict_SetItemString(kwargs, "shape", shape) != 0)
+    throw PythonException(py_fetch_error());
+  if (PyDict_SetItemString(kwargs, "copy", Py_False) != 0)
+    throw PythonException(py_fetch_error());
+
+  PyObject* result = PyObject_Call(type, args, kwargs);
+  if (result == NULL)
+    throw PythonException(py_fetch_error());
+
+  return py_ref(result, convert);
+
+}
+
+// [[Rcpp::export]]
+SEXP py_to_r_sparse_impl(PyObjectRef x, const std::string& format) {
+
+  PyObject* matrix = x.get();
+
+  PyObjectPtr shape(PyObject_GetAttrString(matrix, "shape"));
+  if (shape.is_null())
+    throw PythonException(py_fetch_error());
+  if (!PyTuple_Check(shape) || PyTuple_Size(shape) != 2)
+    stop("sparse matrix shape is not a tuple of length 2");
+  double nrow = py_sparse_size(PyTuple_GetItem(shape, 0));
+  double ncol = py_sparse_size(PyTuple_GetItem(shape, 1));
+  if (nrow < 0 || ncol < 0)
+    stop("sparse matrix shape has negative dimensions");
+  if (nrow > INT_MAX || ncol > INT_MAX)
+    stop("sparse matrix dimensions are too large for Matrix");
+  check_sparse_size(matrix);
+
+  IntegerVector dim = IntegerVector::create((int) nrow, (int) ncol);
+
+  if (format == "coo") {
+    S4 result("dgTMatrix");
+    result.slot("i") = py_to_r_sparse_array(matrix, "row", INTSXP);
+    result.slot("j") = py_to_r_sparse_array(matrix, "col", INTSXP);
+    result.slot("x") = py_to_r_sparse_array(matrix, "data", REALSXP);
+    result.slot("Dim") = dim;
+    return result;
+  }
+
+  if (format != "csc" && format != "csr")
+    stop("unsupported sparse matrix format '%s'", format);
+
+  // Matrix requires sorted indices without duplicates; scipy matrices
+  // needn't have them, in which case we convert a canonical copy
+  PyObjectPtr canonical(PyObject_GetAttrString(matrix, "has_canonical_format"));
+  if (canonical.is_null())
+    throw PythonException(py_fetch_error());
+  PyObjectPtr copy;
+  if (PyObject_IsTrue(canonical) != 1) {
+    copy.assign(PyObject_CallMethod(matrix, "copy", NULL));
+    if (copy.is_null())
+      throw PythonException(py_fetch_error());
+    PyObjectPtr summed(PyObject_CallMethod(copy, "sum_duplicates", NULL));
+    if (summed.is_null())
+      throw PythonException(py_fetch_error());
+    matrix = copy.get();
+  }
+
+  S4 result(format == "csc" ? "dgCMatrix" : "dgRMatrix");
+  result.slot(format == "csc" ? "i" : "j") = py_to_r_sparse_array(matrix, "indices", INTSXP);
+  result.slot("p") = py_to_r_sparse_array(matrix, "indptr", INTSXP);
+  result.slot("x") = py_to_r_sparse_array(matrix, "data", REALSXP);
+  result.slot("Dim") = dim;
+  return result;
+
+}
+
 namespace {
 
 PyObject* r_convert_date_impl(PyObject* datetime,
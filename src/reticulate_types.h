@@ -9,23 +9,28 @@ using namespace reticulate::libpython;
 #define RCPP_NO_SUGAR
 #include <Rcpp.h>
 
+#include <vector>
+
 inline void python_object_finalize(SEXP object);
 
-class PyObjectRef : public Rcpp::Environment {
+// A reference to a Python object, as seen from R. References are normally
+// represented compactly, as an external pointer to the Python object with
+// the 'convert' flag held in the pointer's tag. References may also be
+// backed by an environment, holding the external pointer in a 'pyobj'
+// binding and the flag in a 'convert' binding; these are used where extra
+// state needs to travel with the reference (e.g. module proxies).
+class PyObjectRef : public Rcpp::RObject {
 
 public:
 
-  explicit PyObjectRef(SEXP object) : Rcpp::Environment(object) {}
+  explicit PyObjectRef(SEXP object) : Rcpp::RObject(resolve(object)) {}
 
   explicit PyObjectRef(PyObject* object, bool convert) :
-      Rcpp::Environment(Rcpp::Environment::empty_env().new_child(false)) {
-    set(object);
-    assign("convert", convert);
-  }
+      Rcpp::RObject(make_xptr(object, convert)) {}
 
   PyObject* get() const {
 
-    SEXP pyObject = getFromEnvironment("pyobj");
+    SEXP pyObject = xptr();
     if (pyObject != R_NilValue) {
       PyObject* obj = (PyObject*)R_ExternalPtrAddr(pyObject);
       if (obj != NULL)
@@ -40,7 +45,7 @@ public:
   }
 
   bool is_null_xptr() const {
-    SEXP pyObject = getFromEnvironment("pyobj");
+    SEXP pyObject = xptr();
     if (pyObject == NULL)
       return true;
     else if (pyObject == R_NilValue)
@@ -52,22 +57,106 @@ public:
   }
 
   void set(PyObject* object) {
-    Rcpp::RObject xptr = R_MakeExternalPtr((void*) object, R_NilValue, R_NilValue);
-    R_RegisterCFinalizer(xptr, python_object_finalize);
-    assign("pyobj", xptr);
+
+    if (is_environment()) {
+      Rcpp::RObject xptr = make_xptr(object, convert());
+      Rf_defineVar(Rf_install("pyobj"), xptr, get__());
+      return;
+    }
+
+    SEXP xptr = get__();
+    PyObject* previous = (PyObject*) R_ExternalPtrAddr(xptr);
+    R_SetExternalPtrAddr(xptr, (void*) object);
+    if (previous != NULL)
+      Py_DecRef(previous);
+
   }
 
   bool convert() const {
-    Rcpp::RObject pyObject = getFromEnvironment("convert");
-    if (pyObject == R_NilValue)
+
+    SEXP value = is_environment()
+      ? Rf_findVarInFrame(get__(), Rf_install("convert"))
+      : R_ExternalPtrTag(get__());
+
+    if (value == R_UnboundValue || value == R_NilValue)
       return true;
     else
-      return Rcpp::as<bool>(pyObject);
+      return Rcpp::as<bool>(value);
+
   }
 
+  void set_convert(bool convert) {
+    if (is_environment())
+      Rf_defineVar(Rf_install("convert"), Rf_ScalarLogical(convert), get__());
+    else
+      R_SetExternalPtrTag(get__(), Rf_ScalarLogical(convert));
+  }
+
+  bool is_environment() const {
+    return TYPEOF(get__()) == ENVSXP;
+  }
+
+  // accessors for environment-backed references
+  bool exists(const std::string& name) const {
+    return is_environment() && environment().exists(name);
+  }
 
   SEXP getFromEnvironment(const std::string& name) const {
-    return Rcpp::Environment::get(name);
+    return environment().get(name);
+  }
+
+  void remove(const std::string& name) {
+    environment().remove(name);
+  }
+
+private:
+
+  Rcpp::Environment environment() const {
+    if (!is_environment())
+      Rcpp::stop("Python object reference is not backed by an environment");
+    return Rcpp::Environment(get__());
+  }
+
+  SEXP xptr() const {
+
+    SEXP object = get__();
+    if (TYPEOF(object) == EXTPTRSXP)
+      return object;
+
+    SEXP pyObject = Rf_findVarInFrame(object, Rf_install("pyobj"));
+    return pyObject == R_UnboundValue ? R_NilValue : pyObject;
+
+  }
+
+  static SEXP make_xptr(PyObject* object, bool convert) {
+    SEXP tag = PROTECT(Rf_ScalarLogical(convert));
+    SEXP xptr = PROTECT(R_MakeExternalPtr((void*) object, tag, R_NilValue));
+    R_RegisterCFinalizer(xptr, python_object_finalize);
+    UNPROTECT(2);
+    return xptr;
+  }
+
+  static SEXP resolve(SEXP object) {
+
+    switch (TYPEOF(object)) {
+    case EXTPTRSXP:
+    case ENVSXP:
+      return object;
+    case CLOSXP: {
+      // Python callables manifesting as R functions
+      SEXP pyObject = Rf_getAttrib(object, Rf_install("py_object"));
+      if (TYPEOF(pyObject) == EXTPTRSXP || TYPEOF(pyObject) == ENVSXP)
+        return pyObject;
+    }
+    }
+
+    // defer to as.environment() methods for anything else
+    Rcpp::Function asEnvironment("as.environment", R_BaseEnv);
+    SEXP resolved = asEnvironment(object);
+    if (TYPEOF(resolved) != EXTPTRSXP && TYPEOF(resolved) != ENVSXP)
+      Rcpp::stop("Object is not a Python object reference");
+    return resolved;
+
   }
 
 };
@@ -99,11 +188,29 @@ class GILScope {
   }
 };
 
+// References to Python objects collected by R's garbage collector aren't
+// dropped by their finalizers (which would need the GIL, one object at a
+// time, in the middle of a collection, and wait for it should another
+// thread hold it). They are queued instead, and dropped in one batch when R
+// next calls into Python (see BEGIN_RCPP), when many are queued (see
+// py_decref_later()), and when R exits or Python is finalized.
+extern std::vector<PyObject*> s_pending_decrefs;
+
+// queue a reference to be dropped
+void py_decref_later(PyObject* object);
+
+// drop the queued references
+void py_decref_pending_impl();
+
+inline void py_decref_pending() {
+  if (!s_pending_decrefs.empty())
+    py_decref_pending_impl();
+}
+
 inline void python_object_finalize(SEXP object) {
-  GILScope gilscope;
   PyObject* pyObject = (PyObject*)R_ExternalPtrAddr(object);
   if (pyObject != NULL)
-    Py_DecRef(pyObject);
+    py_decref_later(pyObject);
 }
 
 // define a PythonException struct that we can use to throw an
@@ -130,7 +237,8 @@ struct PythonException {
   (void)rcpp_output_condition;               \
   static SEXP stop_sym = Rf_install("stop"); \
   try {                                      \
-    GILScope gilscope;
+    GILScope gilscope;                       \
+    py_decref_pending();
 
 // This custom END_RCPP is effectively identical to upstream
 // except for the addition of one additional catch block, which
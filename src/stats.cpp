@@ -0,0 +1,26 @@
+#include "stats.h"
+
+#include <cstring>
+
+namespace reticulate {
+namespace stats {
+
+bool s_enabled = false;
+Counters s_counters;
+int Timer::depth_[EVENT_COUNT];
+
+void reset(bool enable) {
+
+  std::memset(s_counters.calls, 0, sizeof(s_counters.calls));
+  std::memset(s_counters.seconds, 0, sizeof(s_counters.seconds));
+  std::memset(s_counters.r_types, 0, sizeof(s_counters.r_types));
+  s_counters.elements = 0;
+  s_counters.bytes = 0;
+  s_counters.py_types.clear();
+
+  s_enabled = enable;
+
+}
+
+} // namespace stats
+} // namespace reticulate
@@ -0,0 +1,134 @@
+#ifndef RETICULATE_STATS_H
+#define RETICULATE_STATS_H
+
+// Counters for conversions and other crossings of the R / Python boundary,
+// as reported by py_conversion_stats(). Collection is off until enabled
+// with py_conversion_stats_reset(), and is compiled out entirely when
+// RETICULATE_NO_STATS is defined. The counters are only updated by threads
+// holding the GIL, which serializes those updates.
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace reticulate {
+namespace stats {
+
+enum Event {
+  PY_TO_R,            // py_to_r()
+  R_TO_PY,            // r_to_py_cpp()
+  R_TO_PY_DISPATCH,   // r_to_py() dispatching to an R-level S3 method
+  PY_REF,             // py_ref()
+  CLASS_LOOKUP,       // computing the R class of a Python type
+  PY_CALL,            // calls of Python callables from R
+  R_CALL,             // calls of R functions from Python
+  PY_FETCH_ERROR,     // py_fetch_error()
+  EVENT_COUNT
+};
+
+struct Counters {
+
+  // the number of times each event occurred, and the time spent in the
+  // outermost occurrences of each event
+  double calls[EVENT_COUNT];
+  double seconds[EVENT_COUNT];
+
+  // the number of (and memory used by) elements copied between R and
+  // Python memory in bulk
+  double elements;
+  double bytes;
+
+  // py_to_r() calls, by Python type (or NumPy array dtype) name, and
+  // r_to_py_cpp() calls, by R type
+  std::map<std::string, double> py_types;
+  double r_types[32];
+
+};
+
+extern bool s_enabled;
+extern Counters s_counters;
+
+// reset all counters, and enable (or disable) their collection
+void reset(bool enable);
+
+// time (and count) an event, for the lifetime of the timer
+class Timer {
+public:
+
+  explicit Timer(Event event)
+    : event_(event), counted_(false), outermost_(false)
+  {
+    if (!s_enabled)
+      return;
+    s_counters.calls[event]++;
+    counted_ = true;
+    if (depth_[event]++ == 0) {
+      outermost_ = true;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~Timer() {
+    if (!counted_)
+      return;
+    depth_[event_]--;
+    if (outermost_) {
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_;
+      s_counters.seconds[event_] += elapsed.count();
+    }
+  }
+
+private:
+  Event event_;
+  bool counted_;
+  bool outermost_;
+  std::chrono::steady_clock::time_point start_;
+  static int depth_[EVENT_COUNT];
+};
+
+} // namespace stats
+} // namespace reticulate
+
+#ifndef RETICULATE_NO_STATS
+
+#define RETICULATE_STATS_TIME(event)                                          \
+  reticulate::stats::Timer reticulate_stats_timer_(reticulate::stats::event)
+
+#define RETICULATE_STATS_COUNT(event)                                         \
+  do {                                                                        \
+    if (reticulate::stats::s_enabled)                                         \
+      reticulate::stats::s_counters.calls[reticulate::stats::event]++;        \
+  } while (0)
+
+#define RETICULATE_STATS_PY_TYPE(name)                                        \
+  do {                                                                        \
+    if (reticulate::stats::s_enabled)                                         \
+      reticulate::stats::s_counters.py_types[(name)]++;                       \
+  } while (0)
+
+#define RETICULATE_STATS_R_TYPE(type)                                         \
+  do {                                                                        \
+    if (reticulate::stats::s_enabled)                                         \
+      reticulate::stats::s_counters.r_types[(type) & 31]++;                   \
+  } while (0)
+
+#define RETICULATE_STATS_COPY(n, size)                                        \
+  do {                                                                        \
+    if (reticulate::stats::s_enabled) {                                       \
+      reticulate::stats::s_counters.elements += (double) (n);                 \
+      reticulate::stats::s_counters.bytes += (double) (size);                 \
+    }                                                                         \
+  } while (0)
+
+#else
+
+#define RETICULATE_STATS_TIME(event)
+#define RETICULATE_STATS_COUNT(event) do {} while (0)
+#define RETICULATE_STATS_PY_TYPE(name) do {} while (0)
+#define RETICULATE_STATS_R_TYPE(type) do {} while (0)
+#define RETICULATE_STATS_COPY(n, size) do {} while (0)
+
+#endif
+
+#endif // RETICULATE_STATS_H